@@ -0,0 +1,172 @@
+#include "generators.hpp"
+
+#include <fmt/format.h>
+#include <iterator>  // back_inserter
+
+
+namespace cqasm::bench {
+
+/**
+ * Returns a cQASM 1.0 program of statement_count single and two-qubit gates,
+ * spread over a register of qubit_count qubits.
+ */
+std::string v1x_gates(std::size_t statement_count, std::size_t qubit_count) {
+    auto ret = fmt::format("version 1.0\nqubits {}\n", qubit_count);
+    auto out = std::back_inserter(ret);
+    for (std::size_t i = 0; i < statement_count; ++i) {
+        auto qubit = i % qubit_count;
+        switch (i % 3) {
+            case 0: fmt::format_to(out, "h q[{}]\n", qubit); break;
+            case 1: fmt::format_to(out, "cnot q[{}], q[{}]\n", qubit, (qubit + 1) % qubit_count); break;
+            default: fmt::format_to(out, "rx q[{}], 0.5\n", qubit); break;
+        }
+    }
+    return ret;
+}
+
+/**
+ * Returns a cQASM 1.0 program of statement_count gates, each one applied to a whole register of qubit_count qubits.
+ */
+std::string v1x_wide_register(std::size_t statement_count, std::size_t qubit_count) {
+    auto ret = fmt::format("version 1.0\nqubits {}\n", qubit_count);
+    auto out = std::back_inserter(ret);
+    for (std::size_t i = 0; i < statement_count; ++i) {
+        fmt::format_to(out, "{} q[0:{}]\n", i % 2 == 0 ? "h" : "x", qubit_count - 1);
+    }
+    return ret;
+}
+
+/**
+ * Returns a cQASM 1.0 program of a single gate whose angle is an expression nested depth levels deep.
+ */
+std::string v1x_deep_expression(std::size_t depth) {
+    auto ret = fmt::format("version 1.0\nqubits 1\nrx q[0], {}1.0", std::string(depth, '('));
+    for (std::size_t i = 0; i < depth; ++i) {
+        ret += " + sin(0.5)) * 0.5";
+    }
+    ret += "\n";
+    return ret;
+}
+
+/**
+ * Returns a cQASM 1.2 program of block_count if statements, each one opening depth nested blocks.
+ * Every block adds a mapping, shadowing the one of the enclosing block, and applies a gate to it.
+ * If gate_count is not 0, the gates cycle through the gate_count extra gates named by v1x_extra_gate_name,
+ * which must then be registered with the analyzer.
+ */
+std::string v1x_nested_blocks(std::size_t block_count, std::size_t depth, std::size_t gate_count) {
+    static constexpr std::size_t qubit_count = 8;
+    auto ret = fmt::format("version 1.2\nqubits {}\nvar c: bool\n", qubit_count);
+    auto out = std::back_inserter(ret);
+    std::size_t gate_index = 0;
+    for (std::size_t i = 0; i < block_count; ++i) {
+        for (std::size_t level = 0; level < depth; ++level) {
+            auto gate = gate_count == 0 ? std::string{ "x" } : v1x_extra_gate_name(gate_index++ % gate_count);
+            fmt::format_to(out, "{0:{1}}if (c) {{\n{0:{2}}map target = q[{3}]\n{0:{2}}{4} target\n",
+                "", level * 4, level * 4 + 4, level % qubit_count, gate);
+        }
+        for (std::size_t level = depth; level-- > 0;) {
+            fmt::format_to(out, "{0:{1}}}}\n", "", level * 4);
+        }
+    }
+    return ret;
+}
+
+/**
+ * Returns the name of the i-th extra gate used by v1x_nested_blocks, to be registered as a single-qubit instruction.
+ */
+std::string v1x_extra_gate_name(std::size_t i) {
+    return fmt::format("gate_{}", i);
+}
+
+/**
+ * Returns a cQASM 3.0 program of statement_count single and two-qubit gates,
+ * spread over a register of qubit_count qubits.
+ */
+std::string v3x_gates(std::size_t statement_count, std::size_t qubit_count) {
+    auto ret = fmt::format("version 3.0\nqubit[{0}] q\nbit[{0}] b\n", qubit_count);
+    auto out = std::back_inserter(ret);
+    for (std::size_t i = 0; i < statement_count; ++i) {
+        auto qubit = i % qubit_count;
+        switch (i % 3) {
+            case 0: fmt::format_to(out, "h q[{}]\n", qubit); break;
+            case 1: fmt::format_to(out, "cnot q[{}], q[{}]\n", qubit, (qubit + 1) % qubit_count); break;
+            default: fmt::format_to(out, "rx q[{}], 0.5\n", qubit); break;
+        }
+    }
+    ret += "b = measure q\n";
+    return ret;
+}
+
+/**
+ * Returns a cQASM 3.0 program of statement_count gates, each one applied to a whole register of qubit_count qubits.
+ */
+std::string v3x_wide_register(std::size_t statement_count, std::size_t qubit_count) {
+    auto ret = fmt::format("version 3.0\nqubit[{0}] q\nbit[{0}] b\n", qubit_count);
+    auto out = std::back_inserter(ret);
+    for (std::size_t i = 0; i < statement_count; ++i) {
+        fmt::format_to(out, "{} q\n", i % 2 == 0 ? "h" : "x");
+    }
+    ret += "b = measure q\n";
+    return ret;
+}
+
+/**
+ * Returns a cQASM 3.0 program of a single constant expression nested depth levels deep,
+ * made of operators and calls to the default functions.
+ */
+std::string v3x_deep_expression(std::size_t depth) {
+    auto ret = fmt::format("version 3.0\nfloat f = {}1.0", std::string(depth, '('));
+    for (std::size_t i = 0; i < depth; ++i) {
+        ret += " + sin(0.5)) * 0.5";
+    }
+    ret += "\n";
+    return ret;
+}
+
+/**
+ * Returns a cQASM 3.0 program defining function_count functions, each one called once.
+ */
+std::string v3x_functions(std::size_t function_count) {
+    std::string ret{ "version 3.0\n" };
+    auto out = std::back_inserter(ret);
+    for (std::size_t i = 0; i < function_count; ++i) {
+        fmt::format_to(out, "def f{}(qubit[2] r) {{\n    h r[0]\n    cnot r[0], r[1]\n}}\n", i);
+    }
+    ret += "qubit[2] q\n";
+    for (std::size_t i = 0; i < function_count; ++i) {
+        fmt::format_to(out, "f{}(q)\n", i);
+    }
+    return ret;
+}
+
+/**
+ * Returns a cQASM 3.0 program of statement_count gates whose operands refer to variable_count variables.
+ */
+std::string v3x_references(std::size_t statement_count, std::size_t variable_count) {
+    static constexpr std::size_t qubit_count = 8;
+    auto ret = fmt::format("version 3.0\nqubit[{}] q\n", qubit_count);
+    auto out = std::back_inserter(ret);
+    for (std::size_t i = 0; i < variable_count; ++i) {
+        fmt::format_to(out, "float a{} = {}\n", i, 1.0 / static_cast<double>(i + 1));
+    }
+    for (std::size_t i = 0; i < statement_count; ++i) {
+        fmt::format_to(out, "rx q[{}], a{}\n", i % qubit_count, i % variable_count);
+    }
+    return ret;
+}
+
+/**
+ * Returns a cQASM 3.0 program initializing an array of size elements with an element-wise constant expression.
+ */
+std::string v3x_constant_array(std::size_t size) {
+    auto ret = fmt::format("version 3.0\nfloat[{}] a = sin({{", size);
+    auto out = std::back_inserter(ret);
+    for (std::size_t i = 0; i < size; ++i) {
+        fmt::format_to(out, "{}{}", i == 0 ? "" : ", ", i);
+    }
+    ret += "}) * 2\n";
+    return ret;
+}
+
+}  // namespace cqasm::bench
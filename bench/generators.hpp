@@ -0,0 +1,76 @@
+/** \file
+ * Generators of the synthetic cQASM programs the benchmarks run on.
+ * All the generated programs are valid, so that every stage, up to the serialization of the semantic tree,
+ * can be measured on them.
+ */
+
+#pragma once
+
+#include <cstddef>  // size_t
+#include <string>
+
+
+namespace cqasm::bench {
+
+/**
+ * Returns a cQASM 1.0 program of statement_count single and two-qubit gates,
+ * spread over a register of qubit_count qubits.
+ */
+std::string v1x_gates(std::size_t statement_count, std::size_t qubit_count);
+
+/**
+ * Returns a cQASM 1.0 program of statement_count gates, each one applied to a whole register of qubit_count qubits.
+ */
+std::string v1x_wide_register(std::size_t statement_count, std::size_t qubit_count);
+
+/**
+ * Returns a cQASM 1.0 program of a single gate whose angle is an expression nested depth levels deep.
+ */
+std::string v1x_deep_expression(std::size_t depth);
+
+/**
+ * Returns a cQASM 1.2 program of block_count if statements, each one opening depth nested blocks.
+ * Every block adds a mapping, shadowing the one of the enclosing block, and applies a gate to it.
+ * If gate_count is not 0, the gates cycle through the gate_count extra gates named by v1x_extra_gate_name,
+ * which must then be registered with the analyzer.
+ */
+std::string v1x_nested_blocks(std::size_t block_count, std::size_t depth, std::size_t gate_count = 0);
+
+/**
+ * Returns the name of the i-th extra gate used by v1x_nested_blocks, to be registered as a single-qubit instruction.
+ */
+std::string v1x_extra_gate_name(std::size_t i);
+
+/**
+ * Returns a cQASM 3.0 program of statement_count single and two-qubit gates,
+ * spread over a register of qubit_count qubits.
+ */
+std::string v3x_gates(std::size_t statement_count, std::size_t qubit_count);
+
+/**
+ * Returns a cQASM 3.0 program of statement_count gates, each one applied to a whole register of qubit_count qubits.
+ */
+std::string v3x_wide_register(std::size_t statement_count, std::size_t qubit_count);
+
+/**
+ * Returns a cQASM 3.0 program of a single constant expression nested depth levels deep,
+ * made of operators and calls to the default functions.
+ */
+std::string v3x_deep_expression(std::size_t depth);
+
+/**
+ * Returns a cQASM 3.0 program defining function_count functions, each one called once.
+ */
+std::string v3x_functions(std::size_t function_count);
+
+/**
+ * Returns a cQASM 3.0 program of statement_count gates whose operands refer to variable_count variables.
+ */
+std::string v3x_references(std::size_t statement_count, std::size_t variable_count);
+
+/**
+ * Returns a cQASM 3.0 program initializing an array of size elements with an element-wise constant expression.
+ */
+std::string v3x_constant_array(std::size_t size);
+
+}  // namespace cqasm::bench
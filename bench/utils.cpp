@@ -0,0 +1,191 @@
+#include "utils.hpp"
+
+#include <algorithm>  // count, sort
+#include <fstream>
+#include <iterator>  // istreambuf_iterator
+#include <limits>  // numeric_limits
+#include <map>
+#include <utility>  // pair
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <unistd.h>  // getpid
+#endif
+
+
+namespace cqasm::bench {
+
+namespace {
+
+/**
+ * The program cached by cached_program, and its key.
+ */
+std::pair<std::string, std::string> &program_cache() {
+    static std::pair<std::string, std::string> cache{};
+    return cache;
+}
+
+/**
+ * Releases the program cached by cached_program, if any.
+ */
+void release_cached_program() {
+    auto &cache = program_cache();
+    cache.first.clear();
+    cache.second.clear();
+    cache.second.shrink_to_fit();
+}
+
+#if defined(__linux__)
+/**
+ * Returns the value of the given field of /proc/self/status, which is in kB, in MB.
+ * Returns std::nullopt if the field cannot be read.
+ */
+std::optional<double> read_status_mb(const std::string &field) {
+    std::ifstream status{ "/proc/self/status" };
+    std::string name{};
+    std::size_t kb{};
+    while (status >> name) {
+        if (name == field + ":" && status >> kb) {
+            return static_cast<double>(kb) / 1024.0;
+        }
+        status.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    return std::nullopt;
+}
+#endif
+
+}  // namespace
+
+/**
+ * Returns the program returned by generate, which is only called if the program is not cached under key yet.
+ * Only the last program is kept, since the runs of a benchmark with the same arguments are consecutive,
+ * and the largest programs take hundreds of MB.
+ */
+const std::string &cached_program(const std::string &key, const std::function<std::string()> &generate) {
+    auto &cache = program_cache();
+    if (cache.first != key) {
+        release_cached_program();
+        cache = { key, generate() };
+    }
+    return cache.second;
+}
+
+/**
+ * Reports the bytes and the lines of the given program as processed on every iteration of the benchmark.
+ */
+void set_program_processed(benchmark::State &state, const std::string &program) {
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * program.size()));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * std::count(program.begin(), program.end(), '\n')));
+}
+
+/**
+ * Starts the measurement.
+ */
+PeakRssDelta::PeakRssDelta() {
+#if defined(__linux__)
+    // Writing 5 to clear_refs resets the peak resident set size to the current one
+    if (std::ofstream clear_refs{ "/proc/self/clear_refs" }; clear_refs << "5" << std::flush) {
+        baseline_mb_ = read_status_mb("VmRSS");
+    }
+#endif
+}
+
+/**
+ * Reports the peak resident set size since the start of the measurement, minus the one at the start, in MB,
+ * as the peak_rss_delta_mb counter of the benchmark.
+ */
+void PeakRssDelta::report([[maybe_unused]] benchmark::State &state) const {
+#if defined(__linux__)
+    if (baseline_mb_.has_value()) {
+        if (auto peak_mb = read_status_mb("VmHWM")) {
+            state.counters["peak_rss_delta_mb"] = *peak_mb - *baseline_mb_;
+        }
+    }
+#endif
+}
+
+TemporaryFile::TemporaryFile(const std::string &data) {
+    static std::size_t file_count = 0;
+#if defined(__linux__) || defined(__APPLE__)
+    auto unique_name = std::to_string(getpid()) + "_" + std::to_string(file_count++);
+#else
+    auto unique_name = std::to_string(file_count++);
+#endif
+    path_ = std::filesystem::temp_directory_path() / ("libqasm_bench_" + unique_name + ".cq");
+    std::ofstream{ path_, std::ios::binary } << data;
+}
+
+TemporaryFile::~TemporaryFile() {
+    std::error_code ec{};
+    std::filesystem::remove(path_, ec);
+}
+
+std::string TemporaryFile::path() const {
+    return path_.string();
+}
+
+ProgramFile::ProgramFile(const std::string &program)
+: file_{ program }
+, size_{ program.size() }
+, line_count_{ static_cast<std::size_t>(std::count(program.begin(), program.end(), '\n')) } {}
+
+/**
+ * Returns the program returned by generate, written to a temporary file,
+ * which is only generated if no file is cached under key yet.
+ * As with cached_program, only the last file is kept.
+ * The program cached by cached_program, if any, is released, so that it does not stay resident either.
+ */
+const ProgramFile &cached_program_file(const std::string &key, const std::function<std::string()> &generate) {
+    static std::string cached_key{};
+    static std::optional<ProgramFile> cached_file{};
+    release_cached_program();
+    if (!cached_file.has_value() || cached_key != key) {
+        cached_file.reset();
+        cached_file.emplace(generate());
+        cached_key = key;
+    }
+    return *cached_file;
+}
+
+/**
+ * Reports the bytes and the lines of the given program file as processed on every iteration of the benchmark.
+ */
+void set_program_processed(benchmark::State &state, const ProgramFile &program) {
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * program.size()));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * program.line_count()));
+}
+
+/**
+ * Returns the input.cq files found under the given directory, relative to the working directory, sorted by path.
+ * The files are only read the first time a directory is asked for.
+ * Returns an empty corpus if the directory does not exist, e.g. if the benchmarks are not run from the project root.
+ */
+const std::vector<CorpusFile> &corpus(const std::string &directory) {
+    static std::map<std::string, std::vector<CorpusFile>> corpora{};
+    if (auto it = corpora.find(directory); it != corpora.end()) {
+        return it->second;
+    }
+    auto &files = corpora[directory];
+    std::error_code ec{};
+    for (std::filesystem::recursive_directory_iterator it{ directory, ec }, end{}; !ec && it != end; it.increment(ec)) {
+        if (it->is_regular_file() && it->path().filename() == "input.cq") {
+            std::ifstream file{ it->path(), std::ios::binary };
+            files.push_back({ it->path().generic_string(), std::string{ std::istreambuf_iterator<char>{ file }, {} } });
+        }
+    }
+    std::sort(files.begin(), files.end(), [](const auto &lhs, const auto &rhs) { return lhs.path < rhs.path; });
+    return files;
+}
+
+/**
+ * Reports the bytes and the files of the given corpus as processed on every iteration of the benchmark.
+ */
+void set_corpus_processed(benchmark::State &state, const std::vector<CorpusFile> &corpus) {
+    std::size_t size = 0;
+    for (const auto &file : corpus) {
+        size += file.data.size();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * corpus.size()));
+}
+
+}  // namespace cqasm::bench
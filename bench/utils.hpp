@@ -0,0 +1,127 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <cstddef>  // size_t
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+
+namespace cqasm::bench {
+
+/**
+ * Returns the program returned by generate, which is only called if the program is not cached under key yet.
+ * Only the last program is kept, since the runs of a benchmark with the same arguments are consecutive,
+ * and the largest programs take hundreds of MB.
+ */
+const std::string &cached_program(const std::string &key, const std::function<std::string()> &generate);
+
+/**
+ * Returns whether the given parse or analysis result has no errors.
+ * Otherwise, the benchmark is skipped, reporting the first error.
+ */
+template <typename Result>
+bool check_result(benchmark::State &state, const Result &result) {
+    if (!result.errors.empty()) {
+        state.SkipWithError(result.errors.front().what());
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Reports the bytes and the lines of the given program as processed on every iteration of the benchmark.
+ */
+void set_program_processed(benchmark::State &state, const std::string &program);
+
+/**
+ * Measures how far the resident set size of the process peaks above what it was when the measurement started,
+ * i.e. the memory used by what runs in between, not counting what earlier benchmarks or the input already hold.
+ * On Linux, the peak resident set size of the process is reset when the measurement starts,
+ * by writing to /proc/self/clear_refs. Elsewhere, or if the peak cannot be reset, nothing is measured.
+ */
+class PeakRssDelta {
+    std::optional<double> baseline_mb_;
+
+public:
+    /**
+     * Starts the measurement.
+     */
+    PeakRssDelta();
+
+    /**
+     * Reports the peak resident set size since the start of the measurement, minus the one at the start, in MB,
+     * as the peak_rss_delta_mb counter of the benchmark.
+     */
+    void report(benchmark::State &state) const;
+};
+
+/**
+ * A file with the given contents in the temporary directory, which is removed when this object is destroyed.
+ */
+class TemporaryFile {
+    std::filesystem::path path_;
+
+public:
+    explicit TemporaryFile(const std::string &data);
+    ~TemporaryFile();
+
+    TemporaryFile(const TemporaryFile &other) = delete;
+    TemporaryFile &operator=(const TemporaryFile &other) = delete;
+
+    [[nodiscard]] std::string path() const;
+};
+
+/**
+ * A program written to a temporary file, for the benchmarks reading their input from a file.
+ * Only the file is kept, so the text of the program is not resident while such a benchmark runs.
+ */
+class ProgramFile {
+    TemporaryFile file_;
+    std::size_t size_;
+    std::size_t line_count_;
+
+public:
+    explicit ProgramFile(const std::string &program);
+
+    [[nodiscard]] std::string path() const { return file_.path(); }
+    [[nodiscard]] std::size_t size() const { return size_; }
+    [[nodiscard]] std::size_t line_count() const { return line_count_; }
+};
+
+/**
+ * Returns the program returned by generate, written to a temporary file,
+ * which is only generated if no file is cached under key yet.
+ * As with cached_program, only the last file is kept.
+ * The program cached by cached_program, if any, is released, so that it does not stay resident either.
+ */
+const ProgramFile &cached_program_file(const std::string &key, const std::function<std::string()> &generate);
+
+/**
+ * Reports the bytes and the lines of the given program file as processed on every iteration of the benchmark.
+ */
+void set_program_processed(benchmark::State &state, const ProgramFile &program);
+
+/**
+ * A cQASM file of a corpus, and its contents.
+ */
+struct CorpusFile {
+    std::string path;
+    std::string data;
+};
+
+/**
+ * Returns the input.cq files found under the given directory, relative to the working directory, sorted by path.
+ * The files are only read the first time a directory is asked for.
+ * Returns an empty corpus if the directory does not exist, e.g. if the benchmarks are not run from the project root.
+ */
+const std::vector<CorpusFile> &corpus(const std::string &directory);
+
+/**
+ * Reports the bytes and the files of the given corpus as processed on every iteration of the benchmark.
+ */
+void set_corpus_processed(benchmark::State &state, const std::vector<CorpusFile> &corpus);
+
+}  // namespace cqasm::bench
@@ -0,0 +1,266 @@
+/** \file
+ * Benchmarks of the v1.x lexer, parser, analyzer, and serializers.
+ */
+
+#include "cqasm-result.hpp"
+#include "generators.hpp"
+#include "utils.hpp"
+#include "v1x/cqasm.hpp"
+#include "v1x/cqasm-analyzer.hpp"
+#include "v1x/cqasm-parse-helper.hpp"
+#include "v1x/cqasm-parser.hpp"
+#include "v1x/cqasm-lexer.hpp"
+
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+#include <optional>
+
+namespace v1x = cqasm::v1x;
+
+
+namespace cqasm::bench {
+
+namespace {
+
+/**
+ * API version of the analyzers, the first one supporting structured control-flow.
+ */
+const std::string api_version = "1.2";
+
+/**
+ * API version of the streaming analyzers, the last one whose semantic tree is made of bundles.
+ */
+const std::string stream_api_version = "1.1";
+
+/**
+ * Number of qubits of the programs whose size is given as a number of statements.
+ */
+constexpr std::size_t qubit_count = 64;
+
+const std::string &gates_program(const benchmark::State &state) {
+    auto statement_count = static_cast<std::size_t>(state.range(0));
+    return cached_program(fmt::format("v1x_gates_{}", statement_count),
+        [=]() { return v1x_gates(statement_count, qubit_count); });
+}
+
+const ProgramFile &gates_program_file(const benchmark::State &state) {
+    auto statement_count = static_cast<std::size_t>(state.range(0));
+    return cached_program_file(fmt::format("v1x_gates_{}", statement_count),
+        [=]() { return v1x_gates(statement_count, qubit_count); });
+}
+
+/**
+ * Scans the given program with the flex lexer of the parser, without parsing it.
+ * Returns the number of tokens.
+ */
+std::size_t lex(const std::string &program) {
+    v1x::parser::ScannerContext context{};
+    context.input = program;
+    yyscan_t scanner{};
+    cqasm_v1x_lex_init_extra(&context, &scanner);
+    YYSTYPE value{};
+    YYLTYPE location{ 1, 1, 1, 1 };
+    std::size_t token_count = 0;
+    while (cqasm_v1x_lex(&value, &location, scanner) != 0) {
+        ++token_count;
+    }
+    cqasm_v1x_lex_destroy(scanner);
+    return token_count;
+}
+
+/**
+ * Measures the analysis of the given program, parsed beforehand.
+ */
+void analyze(benchmark::State &state, v1x::analyzer::Analyzer &analyzer, const std::string &program) {
+    auto parse_result = v1x::parser::parse_string(program, std::nullopt);
+    if (!check_result(state, parse_result)) {
+        return;
+    }
+    auto &ast = *parse_result.root->as_program();
+    PeakRssDelta peak_rss{};
+    for (auto _ : state) {
+        auto result = analyzer.analyze(ast);
+        benchmark::DoNotOptimize(result);
+    }
+    set_program_processed(state, program);
+    peak_rss.report(state);
+}
+
+/**
+ * Returns the analysis result of the given program, for the serialization benchmarks.
+ */
+std::optional<v1x::analyzer::AnalysisResult> analysis_result(benchmark::State &state, const std::string &program) {
+    auto result = v1x::default_analyzer(api_version).analyze_string(program, std::nullopt);
+    if (!check_result(state, result)) {
+        return std::nullopt;
+    }
+    return result;
+}
+
+void v1x_lex(benchmark::State &state) {
+    const auto &program = gates_program(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lex(program));
+    }
+    set_program_processed(state, program);
+}
+BENCHMARK(v1x_lex)->ArgName("statements")->RangeMultiplier(10)->Range(1'000, 10'000'000)
+    ->Unit(benchmark::kMillisecond);
+
+void v1x_parse(benchmark::State &state) {
+    const auto &program = gates_program(state);
+    PeakRssDelta peak_rss{};
+    for (auto _ : state) {
+        auto result = v1x::parser::parse_string(program, std::nullopt);
+        if (!check_result(state, result)) {
+            break;
+        }
+    }
+    set_program_processed(state, program);
+    peak_rss.report(state);
+}
+BENCHMARK(v1x_parse)->ArgName("statements")->RangeMultiplier(10)->Range(1'000, 10'000'000)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Parses a memory-mapped file, to be compared with v1x_parse.
+ */
+void v1x_parse_file(benchmark::State &state) {
+    const auto &file = gates_program_file(state);
+    for (auto _ : state) {
+        auto result = v1x::parser::parse_file(file.path());
+        if (!check_result(state, result)) {
+            break;
+        }
+    }
+    set_program_processed(state, file);
+}
+BENCHMARK(v1x_parse_file)->ArgName("statements")->RangeMultiplier(10)->Range(1'000, 10'000'000)
+    ->Unit(benchmark::kMillisecond);
+
+void v1x_analyze(benchmark::State &state) {
+    auto analyzer = v1x::default_analyzer(api_version);
+    analyze(state, analyzer, gates_program(state));
+}
+BENCHMARK(v1x_analyze)->ArgName("statements")->RangeMultiplier(10)->Range(1'000, 1'000'000)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Parses and analyzes a file as a whole, to be compared with v1x_analyze_stream_file.
+ */
+void v1x_analyze_file(benchmark::State &state) {
+    const auto &file = gates_program_file(state);
+    auto analyzer = v1x::default_analyzer(stream_api_version);
+    PeakRssDelta peak_rss{};
+    for (auto _ : state) {
+        auto result = analyzer.analyze_file(file.path());
+        if (!check_result(state, result)) {
+            break;
+        }
+    }
+    set_program_processed(state, file);
+    peak_rss.report(state);
+}
+BENCHMARK(v1x_analyze_file)->ArgName("statements")->RangeMultiplier(10)->Range(1'000, 1'000'000)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Parses and analyzes a file in streaming mode, dropping every bundle once it is handed over,
+ * so that the peak memory usage does not grow with the number of statements.
+ */
+void v1x_analyze_stream_file(benchmark::State &state) {
+    const auto &file = gates_program_file(state);
+    auto analyzer = v1x::default_analyzer(stream_api_version);
+    PeakRssDelta peak_rss{};
+    for (auto _ : state) {
+        std::size_t bundle_count = 0;
+        auto result = analyzer.analyze_stream_file(file.path(), [&](const auto &, const auto &, auto) {
+            ++bundle_count;
+        });
+        if (!check_result(state, result)) {
+            break;
+        }
+        benchmark::DoNotOptimize(bundle_count);
+    }
+    set_program_processed(state, file);
+    peak_rss.report(state);
+}
+BENCHMARK(v1x_analyze_stream_file)->ArgName("statements")->RangeMultiplier(10)->Range(1'000, 10'000'000)
+    ->Unit(benchmark::kMillisecond);
+
+void v1x_cbor(benchmark::State &state) {
+    const auto &program = gates_program(state);
+    if (auto result = analysis_result(state, program)) {
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(cqasm::result::to_cbor(*result));
+        }
+        set_program_processed(state, program);
+    }
+}
+BENCHMARK(v1x_cbor)->ArgName("statements")->RangeMultiplier(10)->Range(1'000, 1'000'000)
+    ->Unit(benchmark::kMillisecond);
+
+void v1x_json(benchmark::State &state) {
+    const auto &program = gates_program(state);
+    if (auto result = analysis_result(state, program)) {
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(result->to_json());
+        }
+        set_program_processed(state, program);
+    }
+}
+BENCHMARK(v1x_json)->ArgName("statements")->RangeMultiplier(10)->Range(1'000, 1'000'000)
+    ->Unit(benchmark::kMillisecond);
+
+void v1x_analyze_wide_register(benchmark::State &state) {
+    auto register_size = static_cast<std::size_t>(state.range(0));
+    const auto &program = cached_program(fmt::format("v1x_wide_register_{}", register_size),
+        [=]() { return v1x_wide_register(1'000, register_size); });
+    auto analyzer = v1x::default_analyzer(api_version);
+    analyze(state, analyzer, program);
+}
+BENCHMARK(v1x_analyze_wide_register)->ArgName("qubits")->RangeMultiplier(8)->Range(8, 4'096)
+    ->Unit(benchmark::kMillisecond);
+
+void v1x_analyze_deep_expression(benchmark::State &state) {
+    auto depth = static_cast<std::size_t>(state.range(0));
+    const auto &program = cached_program(fmt::format("v1x_deep_expression_{}", depth),
+        [=]() { return v1x_deep_expression(depth); });
+    auto analyzer = v1x::default_analyzer(api_version);
+    analyze(state, analyzer, program);
+}
+BENCHMARK(v1x_analyze_deep_expression)->ArgName("depth")->RangeMultiplier(4)->Range(16, 1'024);
+
+/**
+ * 100 if statements opening nested blocks, each one of which gets a scope.
+ */
+void v1x_analyze_nested_blocks(benchmark::State &state) {
+    auto depth = static_cast<std::size_t>(state.range(0));
+    const auto &program = cached_program(fmt::format("v1x_nested_blocks_{}", depth),
+        [=]() { return v1x_nested_blocks(100, depth); });
+    auto analyzer = v1x::default_analyzer(api_version);
+    analyze(state, analyzer, program);
+}
+BENCHMARK(v1x_analyze_nested_blocks)->ArgName("depth")->RangeMultiplier(4)->Range(1, 256)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Same as v1x_analyze_nested_blocks, but with a larger instruction set, which the scopes of the blocks share.
+ */
+void v1x_analyze_wide_instruction_set(benchmark::State &state) {
+    auto gate_count = static_cast<std::size_t>(state.range(0));
+    auto depth = static_cast<std::size_t>(state.range(1));
+    const auto &program = cached_program(fmt::format("v1x_wide_instruction_set_{}_{}", gate_count, depth),
+        [=]() { return v1x_nested_blocks(100, depth, gate_count); });
+    auto analyzer = v1x::default_analyzer(api_version);
+    for (std::size_t i = 0; i < gate_count; ++i) {
+        analyzer.register_instruction(v1x_extra_gate_name(i), "Q");
+    }
+    analyze(state, analyzer, program);
+}
+BENCHMARK(v1x_analyze_wide_instruction_set)->ArgNames({ "instructions", "depth" })
+    ->ArgsProduct({ { 100, 1'000, 10'000 }, { 1, 16, 64 } })->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+}  // namespace cqasm::bench
@@ -0,0 +1,460 @@
+/** \file
+ * Benchmarks of the v3.x lexer, parser, analyzer, and serializers.
+ */
+
+#include "cqasm-result.hpp"
+#include "generators.hpp"
+#include "utils.hpp"
+#include "v3x/cqasm.hpp"
+#include "v3x/cqasm-analyzer.hpp"
+#include "v3x/cqasm-functions.hpp"
+#include "v3x/cqasm-parse-helper.hpp"
+#include "v3x/cqasm-types.hpp"
+#include "v3x/cqasm-values.hpp"
+#include "v3x/CqasmLexer.h"
+#include "v3x/StringViewInputStream.hpp"
+
+#include <antlr4-runtime.h>
+#include <benchmark/benchmark.h>
+#include <fmt/format.h>
+#include <fstream>
+#include <iterator>  // istreambuf_iterator
+#include <optional>
+#include <string>
+
+namespace v3x = cqasm::v3x;
+
+
+namespace cqasm::bench {
+
+namespace {
+
+/**
+ * Number of qubits of the programs whose size is given as a number of statements.
+ */
+constexpr std::size_t qubit_count = 64;
+
+const std::string &gates_program(const benchmark::State &state) {
+    auto statement_count = static_cast<std::size_t>(state.range(0));
+    return cached_program(fmt::format("v3x_gates_{}", statement_count),
+        [=]() { return v3x_gates(statement_count, qubit_count); });
+}
+
+const ProgramFile &gates_program_file(const benchmark::State &state) {
+    auto statement_count = static_cast<std::size_t>(state.range(0));
+    return cached_program_file(fmt::format("v3x_gates_{}", statement_count),
+        [=]() { return v3x_gates(statement_count, qubit_count); });
+}
+
+/**
+ * Directory of the cQASM 3.0 corpus, relative to the project root.
+ */
+constexpr const char *corpus_directory = "res/v3x";
+
+/**
+ * Scans the given input with the ANTLR lexer of the parser, without parsing it.
+ * Returns the number of tokens.
+ */
+std::size_t lex(antlr4::CharStream &input) {
+    CqasmLexer lexer{ &input };
+    antlr4::CommonTokenStream tokens{ &lexer };
+    tokens.fill();
+    return tokens.size();
+}
+
+/**
+ * Measures the analysis of the given program, parsed beforehand.
+ */
+void analyze(benchmark::State &state, v3x::analyzer::Analyzer &analyzer, const std::string &program) {
+    auto parse_result = v3x::parser::parse_string(program, std::nullopt);
+    if (!check_result(state, parse_result)) {
+        return;
+    }
+    auto &ast = *parse_result.root->as_program();
+    PeakRssDelta peak_rss{};
+    for (auto _ : state) {
+        auto result = analyzer.analyze(ast);
+        benchmark::DoNotOptimize(result);
+    }
+    set_program_processed(state, program);
+    peak_rss.report(state);
+}
+
+/**
+ * Returns the analysis result of the given program, for the serialization benchmarks.
+ */
+std::optional<v3x::analyzer::AnalysisResult> analysis_result(benchmark::State &state, const std::string &program) {
+    auto result = v3x::default_analyzer().analyze_string(program, std::nullopt);
+    if (!check_result(state, result)) {
+        return std::nullopt;
+    }
+    return result;
+}
+
+/**
+ * Lexes from a view of the program, as the parser does.
+ */
+void v3x_lex(benchmark::State &state) {
+    const auto &program = gates_program(state);
+    v3x::parser::warm_up();
+    PeakRssDelta peak_rss{};
+    for (auto _ : state) {
+        v3x::parser::StringViewInputStream input{ program };
+        benchmark::DoNotOptimize(lex(input));
+    }
+    set_program_processed(state, program);
+    peak_rss.report(state);
+}
+BENCHMARK(v3x_lex)->ArgName("statements")->RangeMultiplier(10)->Range(1'000, 10'000'000)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Lexes from a copy of the program decoded to UTF-32 by antlr4::ANTLRInputStream,
+ * as the parser did before reading from a view, to be compared with v3x_lex.
+ */
+void v3x_lex_copy(benchmark::State &state) {
+    const auto &program = gates_program(state);
+    v3x::parser::warm_up();
+    PeakRssDelta peak_rss{};
+    for (auto _ : state) {
+        antlr4::ANTLRInputStream input{ program };
+        benchmark::DoNotOptimize(lex(input));
+    }
+    set_program_processed(state, program);
+    peak_rss.report(state);
+}
+BENCHMARK(v3x_lex_copy)->ArgName("statements")->RangeMultiplier(10)->Range(1'000, 10'000'000)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * The second argument selects the prediction mode, 0 for SLL first, and 1 for full LL only.
+ */
+void v3x_parse(benchmark::State &state) {
+    const auto &program = gates_program(state);
+    auto prediction_mode = state.range(1) == 0
+        ? v3x::parser::PredictionMode::sll_first
+        : v3x::parser::PredictionMode::ll;
+    v3x::parser::warm_up();
+    PeakRssDelta peak_rss{};
+    for (auto _ : state) {
+        auto result = v3x::parser::parse_string(program, std::nullopt, prediction_mode);
+        if (!check_result(state, result)) {
+            break;
+        }
+    }
+    set_program_processed(state, program);
+    peak_rss.report(state);
+}
+BENCHMARK(v3x_parse)->ArgNames({ "statements", "ll" })
+    ->ArgsProduct({ benchmark::CreateRange(1'000, 10'000'000, 10), { 0, 1 } })->Unit(benchmark::kMillisecond);
+
+/**
+ * Parses a memory-mapped file, to be compared with v3x_parse_file_copy.
+ */
+void v3x_parse_file(benchmark::State &state) {
+    const auto &file = gates_program_file(state);
+    v3x::parser::warm_up();
+    PeakRssDelta peak_rss{};
+    for (auto _ : state) {
+        auto result = v3x::parser::parse_file(file.path(), std::nullopt);
+        if (!check_result(state, result)) {
+            break;
+        }
+    }
+    set_program_processed(state, file);
+    peak_rss.report(state);
+}
+BENCHMARK(v3x_parse_file)->ArgName("statements")->RangeMultiplier(10)->Range(1'000, 10'000'000)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Reads a file into a string, and parses the string, to be compared with v3x_parse_file.
+ */
+void v3x_parse_file_copy(benchmark::State &state) {
+    const auto &file = gates_program_file(state);
+    v3x::parser::warm_up();
+    PeakRssDelta peak_rss{};
+    for (auto _ : state) {
+        std::ifstream input{ file.path(), std::ios::binary };
+        const auto program = std::string{ std::istreambuf_iterator<char>{ input }, {} };
+        auto result = v3x::parser::parse_string(program, std::nullopt);
+        if (!check_result(state, result)) {
+            break;
+        }
+    }
+    set_program_processed(state, file);
+    peak_rss.report(state);
+}
+BENCHMARK(v3x_parse_file_copy)->ArgName("statements")->RangeMultiplier(10)->Range(1'000, 10'000'000)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Parses every file of the res/v3x corpus, with their paths as file names.
+ * The second argument selects the prediction mode, 0 for SLL first, and 1 for full LL only.
+ * Some of the files have errors on purpose, so the results are not checked.
+ */
+void v3x_parse_corpus(benchmark::State &state) {
+    const auto &files = corpus(corpus_directory);
+    if (files.empty()) {
+        state.SkipWithError("no corpus found in res/v3x, the benchmarks must be run from the project root");
+        return;
+    }
+    auto prediction_mode = state.range(0) == 0
+        ? v3x::parser::PredictionMode::sll_first
+        : v3x::parser::PredictionMode::ll;
+    v3x::parser::warm_up();
+    PeakRssDelta peak_rss{};
+    for (auto _ : state) {
+        for (const auto &file : files) {
+            benchmark::DoNotOptimize(v3x::parser::parse_string(file.data, file.path, prediction_mode));
+        }
+    }
+    set_corpus_processed(state, files);
+    peak_rss.report(state);
+}
+BENCHMARK(v3x_parse_corpus)->ArgName("ll")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+/**
+ * Parses and analyzes every file of the res/v3x corpus, with their paths as file names.
+ */
+void v3x_parse_and_analyze_corpus(benchmark::State &state) {
+    const auto &files = corpus(corpus_directory);
+    if (files.empty()) {
+        state.SkipWithError("no corpus found in res/v3x, the benchmarks must be run from the project root");
+        return;
+    }
+    auto analyzer = v3x::default_analyzer();
+    v3x::parser::warm_up();
+    PeakRssDelta peak_rss{};
+    for (auto _ : state) {
+        for (const auto &file : files) {
+            benchmark::DoNotOptimize(analyzer.analyze_string(file.data, file.path));
+        }
+    }
+    set_corpus_processed(state, files);
+    peak_rss.report(state);
+}
+BENCHMARK(v3x_parse_and_analyze_corpus)->Unit(benchmark::kMillisecond);
+
+/**
+ * Parses a small program with empty DFA caches, as the first parse in a process does.
+ */
+void v3x_parse_cold(benchmark::State &state) {
+    const auto &program = gates_program(state);
+    for (auto _ : state) {
+        state.PauseTiming();
+        v3x::parser::clear_dfa_cache();
+        state.ResumeTiming();
+        auto result = v3x::parser::parse_string(program, std::nullopt);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(v3x_parse_cold)->ArgName("statements")->Arg(100)->Unit(benchmark::kMillisecond);
+
+void v3x_analyze(benchmark::State &state) {
+    auto analyzer = v3x::default_analyzer();
+    analyze(state, analyzer, gates_program(state));
+}
+BENCHMARK(v3x_analyze)->ArgName("statements")->RangeMultiplier(10)->Range(1'000, 1'000'000)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Parses and analyzes, with the tree nodes allocated from an arena if the second argument is 1.
+ */
+void v3x_parse_and_analyze(benchmark::State &state) {
+    const auto &program = gates_program(state);
+    auto analyzer = v3x::default_analyzer();
+    analyzer.use_arena = state.range(1) != 0;
+    PeakRssDelta peak_rss{};
+    for (auto _ : state) {
+        auto result = analyzer.analyze_string(program, std::nullopt);
+        if (!check_result(state, result)) {
+            break;
+        }
+    }
+    set_program_processed(state, program);
+    peak_rss.report(state);
+}
+BENCHMARK(v3x_parse_and_analyze)->ArgNames({ "statements", "arena" })
+    ->ArgsProduct({ benchmark::CreateRange(1'000, 1'000'000, 10), { 0, 1 } })->Unit(benchmark::kMillisecond);
+
+/**
+ * Parses and analyzes with a file name of the length given by the second argument, or none if it is 0,
+ * so that every source location of the AST and of the semantic tree refers to it.
+ */
+void v3x_parse_and_analyze_with_file_name(benchmark::State &state) {
+    const auto &program = gates_program(state);
+    auto file_name_length = static_cast<std::size_t>(state.range(1));
+    auto file_name = file_name_length == 0
+        ? std::nullopt
+        : std::optional<std::string>{ "/" + std::string(file_name_length - 4, 'd') + ".cq" };
+    auto analyzer = v3x::default_analyzer();
+    PeakRssDelta peak_rss{};
+    for (auto _ : state) {
+        auto result = analyzer.analyze_string(program, file_name);
+        if (!check_result(state, result)) {
+            break;
+        }
+    }
+    set_program_processed(state, program);
+    peak_rss.report(state);
+}
+BENCHMARK(v3x_parse_and_analyze_with_file_name)->ArgNames({ "statements", "file_name_length" })
+    ->ArgsProduct({ benchmark::CreateRange(1'000, 1'000'000, 10), { 0, 256 } })->Unit(benchmark::kMillisecond);
+
+/**
+ * Only measures the destruction of the trees, allocated from an arena if the second argument is 1.
+ */
+void v3x_destroy_trees(benchmark::State &state) {
+    const auto &program = gates_program(state);
+    auto analyzer = v3x::default_analyzer();
+    analyzer.use_arena = state.range(1) != 0;
+    std::optional<v3x::analyzer::AnalysisResult> result{};
+    for (auto _ : state) {
+        state.PauseTiming();
+        result.emplace(analyzer.analyze_string(program, std::nullopt));
+        state.ResumeTiming();
+        result.reset();
+    }
+}
+BENCHMARK(v3x_destroy_trees)->ArgNames({ "statements", "arena" })
+    ->ArgsProduct({ benchmark::CreateRange(1'000, 1'000'000, 10), { 0, 1 } })->Unit(benchmark::kMillisecond);
+
+void v3x_cbor(benchmark::State &state) {
+    const auto &program = gates_program(state);
+    if (auto result = analysis_result(state, program)) {
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(cqasm::result::to_cbor(*result));
+        }
+        set_program_processed(state, program);
+    }
+}
+BENCHMARK(v3x_cbor)->ArgName("statements")->RangeMultiplier(10)->Range(1'000, 1'000'000)
+    ->Unit(benchmark::kMillisecond);
+
+void v3x_json(benchmark::State &state) {
+    const auto &program = gates_program(state);
+    if (auto result = analysis_result(state, program)) {
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(result->to_json());
+        }
+        set_program_processed(state, program);
+    }
+}
+BENCHMARK(v3x_json)->ArgName("statements")->RangeMultiplier(10)->Range(1'000, 1'000'000)
+    ->Unit(benchmark::kMillisecond);
+
+void v3x_analyze_wide_register(benchmark::State &state) {
+    auto register_size = static_cast<std::size_t>(state.range(0));
+    const auto &program = cached_program(fmt::format("v3x_wide_register_{}", register_size),
+        [=]() { return v3x_wide_register(1'000, register_size); });
+    auto analyzer = v3x::default_analyzer();
+    analyze(state, analyzer, program);
+}
+BENCHMARK(v3x_analyze_wide_register)->ArgName("qubits")->RangeMultiplier(8)->Range(8, 4'096)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * The second argument is 0 to disable constant folding, by overriding one of the default functions.
+ */
+void v3x_analyze_deep_expression(benchmark::State &state) {
+    auto depth = static_cast<std::size_t>(state.range(0));
+    const auto &program = cached_program(fmt::format("v3x_deep_expression_{}", depth),
+        [=]() { return v3x_deep_expression(depth); });
+    auto analyzer = v3x::default_analyzer();
+    if (state.range(1) == 0) {
+        analyzer.register_function_impl("operator+", "ii", v3x::functions::op_add_ii);
+    }
+    analyze(state, analyzer, program);
+}
+BENCHMARK(v3x_analyze_deep_expression)->ArgNames({ "depth", "folding" })
+    ->ArgsProduct({ benchmark::CreateRange(16, 1'024, 4), { 0, 1 } });
+
+void v3x_analyze_functions(benchmark::State &state) {
+    auto function_count = static_cast<std::size_t>(state.range(0));
+    const auto &program = cached_program(fmt::format("v3x_functions_{}", function_count),
+        [=]() { return v3x_functions(function_count); });
+    auto analyzer = v3x::default_analyzer();
+    analyze(state, analyzer, program);
+}
+BENCHMARK(v3x_analyze_functions)->ArgName("functions")->RangeMultiplier(10)->Range(10, 10'000)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Statements referring to 100 variables.
+ */
+void v3x_analyze_references(benchmark::State &state) {
+    auto statement_count = static_cast<std::size_t>(state.range(0));
+    const auto &program = cached_program(fmt::format("v3x_references_{}", statement_count),
+        [=]() { return v3x_references(statement_count, 100); });
+    auto analyzer = v3x::default_analyzer();
+    analyze(state, analyzer, program);
+}
+BENCHMARK(v3x_analyze_references)->ArgName("statements")->RangeMultiplier(10)->Range(1'000, 1'000'000)
+    ->Unit(benchmark::kMillisecond);
+
+const std::string &constant_array_program(const benchmark::State &state) {
+    auto size = static_cast<std::size_t>(state.range(0));
+    return cached_program(fmt::format("v3x_constant_array_{}", size), [=]() { return v3x_constant_array(size); });
+}
+
+void v3x_analyze_constant_array(benchmark::State &state) {
+    auto analyzer = v3x::default_analyzer();
+    analyze(state, analyzer, constant_array_program(state));
+}
+BENCHMARK(v3x_analyze_constant_array)->ArgName("elements")->RangeMultiplier(10)->Range(1'000, 100'000)
+    ->Unit(benchmark::kMillisecond);
+
+void v3x_cbor_constant_array(benchmark::State &state) {
+    const auto &program = constant_array_program(state);
+    if (auto result = analysis_result(state, program)) {
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(cqasm::result::to_cbor(*result));
+        }
+        set_program_processed(state, program);
+    }
+}
+BENCHMARK(v3x_cbor_constant_array)->ArgName("elements")->RangeMultiplier(10)->Range(1'000, 100'000)
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Builds the default analyzer configuration, as done for every Python analyzer object, among others.
+ */
+void v3x_default_analyzer(benchmark::State &state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(v3x::default_analyzer());
+    }
+}
+BENCHMARK(v3x_default_analyzer);
+
+/**
+ * Constructs an analyzer sharing an existing configuration, as done for every program of a batch.
+ */
+void v3x_analyzer_from_config(benchmark::State &state) {
+    auto config = v3x::default_analyzer_config();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(v3x::analyzer::Analyzer{ config });
+    }
+}
+BENCHMARK(v3x_analyzer_from_config);
+
+void v3x_promote(benchmark::State &state) {
+    v3x::values::Value value = tree::make<v3x::values::ConstInt>(1);
+    const auto &type = v3x::types::interned<v3x::types::Float>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(v3x::values::promote(value, type));
+    }
+}
+BENCHMARK(v3x_promote);
+
+void v3x_type_of(benchmark::State &state) {
+    v3x::values::Value value = tree::make<v3x::values::ConstFloat>(0.5);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(v3x::values::type_of(value));
+    }
+}
+BENCHMARK(v3x_type_of);
+
+}  // namespace
+
+}  // namespace cqasm::bench
@@ -30,6 +30,7 @@ class LibqasmConan(ConanFile):
         "shared": [True, False],
         "fPIC": [True, False],
         "asan_enabled": [True, False],
+        "build_benchmarks": [True, False],
         "build_python": [True, False],
         "build_tests": [True, False],
         "compat": [True, False],
@@ -42,6 +43,7 @@ class LibqasmConan(ConanFile):
         "shared": False,
         "fPIC": True,
         "asan_enabled": False,
+        "build_benchmarks": False,
         "build_python": False,
         "build_tests": False,
         "compat": False,
@@ -52,7 +54,7 @@ class LibqasmConan(ConanFile):
     }
 
     exports = "version.py", "include/version.hpp"
-    exports_sources = "CMakeLists.txt", "include/*", "python/*", "res/*", "scripts/*", "src/*", "test/*"
+    exports_sources = "CMakeLists.txt", "bench/*", "include/*", "python/*", "res/*", "scripts/*", "src/*", "test/*"
 
     def build_requirements(self):
         self.tool_requires("m4/1.4.19")
@@ -67,6 +69,8 @@ class LibqasmConan(ConanFile):
             self.tool_requires("emsdk/3.1.50")
         if self.options.build_tests:
             self.test_requires("gtest/1.14.0")
+        if self.options.build_benchmarks:
+            self.test_requires("benchmark/1.8.3")
 
     def requirements(self):
         self.requires("fmt/10.2.1")
@@ -100,6 +104,7 @@ class LibqasmConan(ConanFile):
         deps.generate()
         tc = CMakeToolchain(self)
         tc.variables["ASAN_ENABLED"] = self.options.asan_enabled
+        tc.variables["LIBQASM_BUILD_BENCHMARKS"] = self.options.build_benchmarks
         tc.variables["LIBQASM_BUILD_EMSCRIPTEN"] = self.settings.arch == "wasm"
         tc.variables["LIBQASM_BUILD_PYTHON"] = self.options.build_python
         tc.variables["LIBQASM_BUILD_TESTS"] = self.options.build_tests
@@ -6,12 +6,41 @@
 
 #include <cstdint>
 #include <fmt/ostream.h>
+#include <memory>  // shared_ptr
 #include <optional>
+#include <ostream>
 #include <string>
+#include <string_view>
 
 
 namespace cqasm::annotations {
 
+/**
+ * Shared source file name.
+ * Copies of a FileName share a single reference-counted string,
+ * so a parser constructs one per parse and the source location of every node only holds a pointer to it.
+ * The string is freed together with the last source location referring to it.
+ */
+class FileName {
+    std::shared_ptr<const std::string> name_;
+
+public:
+    /**
+     * Constructs a file name, holding a new copy of the given name.
+     */
+    explicit FileName(std::string_view name);
+
+    [[nodiscard]] const std::string &str() const { return *name_; }
+
+    bool operator==(const FileName &other) const { return name_ == other.name_ || *name_ == *other.name_; }
+    bool operator==(std::string_view other) const { return *name_ == other; }
+};
+
+/**
+ * Stream << overload for file names.
+ */
+std::ostream &operator<<(std::ostream &os, const FileName &object);
+
 /**
  * Source location annotation object, containing source file line numbers etc.
  */
@@ -50,7 +79,7 @@ struct SourceLocation {
     /**
      * The name of the source file.
      */
-    std::optional<std::string> file_name;
+    std::optional<FileName> file_name;
 
     /**
      * The source location range.
@@ -62,6 +91,8 @@ struct SourceLocation {
      */
     SourceLocation() = default;
     explicit SourceLocation(const std::optional<std::string> &file_name, const Range &range);
+    explicit SourceLocation(const std::optional<FileName> &file_name, const Range &range);
+    explicit SourceLocation(std::nullopt_t, const Range &range);
     SourceLocation(const SourceLocation &other) = default;
     SourceLocation(SourceLocation &&other) noexcept = default;
     SourceLocation& operator=(const SourceLocation &other) = default;
@@ -93,4 +124,5 @@ std::ostream &operator<<(std::ostream &os, const SourceLocation &object);
 /**
  * std::ostream support via fmt (uses operator<<).
  */
+template <> struct fmt::formatter<cqasm::annotations::FileName> : ostream_formatter {};
 template <> struct fmt::formatter<cqasm::annotations::SourceLocation> : ostream_formatter {};
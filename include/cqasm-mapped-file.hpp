@@ -0,0 +1,63 @@
+/** \file
+ * Defines the \ref cqasm::utils::MappedFile "MappedFile" class,
+ * a read-only view over the whole contents of a file.
+ */
+
+#pragma once
+
+#include <cstddef>  // size_t
+#include <string>
+#include <string_view>
+
+
+namespace cqasm::utils {
+
+/**
+ * Read-only view over the whole contents of a file.
+ *
+ * The file is memory-mapped whenever the platform allows it,
+ * so that scanners can consume it directly, without copying it into an intermediate buffer.
+ * Otherwise, the contents are read into memory owned by this object.
+ * In both cases, the data is released when the object is destroyed.
+ */
+class MappedFile {
+    /**
+     * Start of the mapped region, or nullptr if the file is not mapped.
+     */
+    void *address_{ nullptr };
+
+    /**
+     * Size of the mapped region.
+     */
+    std::size_t size_{ 0 };
+
+    /**
+     * Contents of the file, if it could not be mapped.
+     */
+    std::string contents_;
+
+public:
+    /**
+     * Maps the given file.
+     * Throws a ParseError if the file cannot be opened.
+     */
+    explicit MappedFile(const std::string &file_path);
+
+    /**
+     * Unmaps the file.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile &other) = delete;
+    MappedFile(MappedFile &&other) = delete;
+    MappedFile &operator=(const MappedFile &other) = delete;
+    MappedFile &operator=(MappedFile &&other) = delete;
+
+    /**
+     * Returns the contents of the file.
+     * The returned view is valid for as long as this object is alive.
+     */
+    [[nodiscard]] std::string_view data() const;
+};
+
+} // namespace cqasm::utils
@@ -3,16 +3,23 @@
 #include "cqasm-overload.hpp"
 #include "cqasm-tree.hpp"
 
+#include <array>
+#include <cstddef>  // size_t
 #include <exception>
+#include <functional>  // equal_to, hash
+#include <mutex>  // unique_lock
+#include <optional>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
-#include <utility>  // pair
+#include <utility>  // move, pair
 #include <vector>
 
 
 /**
- * Overload templates are case-sensitive.
- * The code using them can be case-insensitive by converting to lowercase before adding and resolving an overload.
+ * Overload templates are case-sensitive by default.
+ * The code using them can be case-insensitive by instantiating OverloadedNameResolver
+ * with a case-insensitive hash and equality.
  */
 namespace cqasm::overload {
 
@@ -20,6 +27,27 @@ struct NameResolutionFailure : public std::exception {};
 struct OverloadResolutionFailure : public std::exception {};
 
 
+//--------------//
+// PromotionKey //
+//--------------//
+
+/**
+ * Identifies a value as far as promotion is concerned:
+ * values with the same key can be promoted to exactly the same types.
+ * value_kind and type_kind are the node types of the value and of its type.
+ * dims holds the dimensions the promotion rules depend on, e.g. the number of elements of an array,
+ * or the number of rows and columns of a matrix; unused dimensions are zero.
+ */
+struct PromotionKey {
+    int value_kind{};
+    int type_kind{};
+    bool assignable{};
+    std::array<std::size_t, 2> dims{};
+
+    bool operator==(const PromotionKey &other) const = default;
+};
+
+
 //----------//
 // Overload //
 //----------//
@@ -77,6 +105,11 @@ public:
  * but maybe also a lambda to represent the actual function.
  * Note that ambiguous overloads are silently resolved by using the last applicable overload,
  * so more specific overloads should always be added last.
+ *
+ * Resolutions are memoized by the promotion keys of the arguments,
+ * as returned by a PromotionKey promotion_key(const Value &) function found by argument-dependent lookup.
+ * Two values with the same promotion key must be promotable to exactly the same types.
+ * The memo is bounded, and internally synchronized, so resolve can be called concurrently.
  */
 template <class T, class TypeBase, class Node>
 class OverloadResolver {
@@ -87,14 +120,120 @@ class OverloadResolver {
 
     std::vector<Overload<T, TypeBase>> overloads;
 
+    /**
+     * Indices into overloads of the overloads with a given number of parameters, last added first.
+     */
+    std::unordered_map<std::size_t, std::vector<std::size_t>> overloads_by_arity;
+
+    /**
+     * Argument lists with more arguments than this are not memoized.
+     */
+    static constexpr std::size_t max_memoized_arity = 4;
+
+    /**
+     * Maximum number of memoized resolutions. The memo is cleared when it is full,
+     * so that a resolver living in a long-lived configuration does not grow without bound.
+     */
+    static constexpr std::size_t max_memoized_resolutions = 256;
+
+    /**
+     * The signature of an argument list, i.e. the number of arguments and their promotion keys.
+     */
+    struct Signature {
+        std::size_t arity{};
+        std::array<PromotionKey, max_memoized_arity> keys{};
+
+        bool operator==(const Signature &other) const = default;
+    };
+
+    struct SignatureHash {
+        std::size_t operator()(const Signature &signature) const noexcept {
+            std::size_t ret = signature.arity;
+            const auto combine = [&ret](std::size_t value) {
+                ret ^= value + 0x9e3779b9 + (ret << 6) + (ret >> 2);
+            };
+            for (std::size_t i = 0; i < signature.arity; ++i) {
+                const auto &key = signature.keys[i];
+                combine(static_cast<std::size_t>(key.value_kind));
+                combine(static_cast<std::size_t>(key.type_kind));
+                combine(static_cast<std::size_t>(key.assignable));
+                combine(key.dims[0]);
+                combine(key.dims[1]);
+            }
+            return ret;
+        }
+    };
+
+    /**
+     * Memoized resolutions, from the signature of an argument list to the index of the resolved overload,
+     * or to std::nullopt if no overload applies.
+     */
+    std::unordered_map<Signature, std::optional<std::size_t>, SignatureHash> resolutions;
+    std::shared_mutex resolutions_mutex;
+
+    /**
+     * Returns the signature of an argument list,
+     * or std::nullopt if the argument list is too long to be memoized.
+     */
+    [[nodiscard]] static std::optional<Signature> signature_of(const Values &args) {
+        if (args.size() > max_memoized_arity) {
+            return std::nullopt;
+        }
+        Signature ret{ args.size() };
+        for (size_t i = 0; i < args.size(); i++) {
+            ret.keys[i] = promotion_key(args.at(i));
+        }
+        return ret;
+    }
+
+    /**
+     * Promotes the arguments to the parameter types of the given overload.
+     * Returns std::nullopt if any of the arguments cannot be promoted.
+     */
+    [[nodiscard]] static std::optional<Values> promote_args(const Overload<T, TypeBase> &overload, const Values &args) {
+        Values promoted_args;
+        for (size_t i = 0; i < args.size(); i++) {
+            auto promoted_arg = promote(args.at(i), overload.param_type_at(i));
+            if (promoted_arg.empty()) {
+                return std::nullopt;
+            }
+            promoted_args.add(promoted_arg);
+        }
+        return promoted_args;
+    }
+
 public:
+    OverloadResolver() = default;
+    OverloadResolver(const OverloadResolver &other)
+    : overloads{ other.overloads }, overloads_by_arity{ other.overloads_by_arity } {}
+    OverloadResolver(OverloadResolver &&other) noexcept
+    : overloads{ std::move(other.overloads) }, overloads_by_arity{ std::move(other.overloads_by_arity) } {}
+    OverloadResolver& operator=(const OverloadResolver &other) {
+        overloads = other.overloads;
+        overloads_by_arity = other.overloads_by_arity;
+        std::unique_lock lock{ resolutions_mutex };
+        resolutions.clear();
+        return *this;
+    }
+    OverloadResolver& operator=(OverloadResolver &&other) noexcept {
+        overloads = std::move(other.overloads);
+        overloads_by_arity = std::move(other.overloads_by_arity);
+        std::unique_lock lock{ resolutions_mutex };
+        resolutions.clear();
+        return *this;
+    }
+
     /**
      * Adds a possible overload to the resolver.
      * Note that ambiguous overloads are silently resolved by using the last applicable overload,
      * so more specific overloads should always be added last.
      */
     void add_overload(const T &tag, const Types &param_types) {
+        auto &same_arity_overloads = overloads_by_arity[param_types.size()];
+        same_arity_overloads.insert(same_arity_overloads.begin(), overloads.size());
         overloads.emplace_back(tag, param_types);
+        std::unique_lock lock{ resolutions_mutex };
+        resolutions.clear();
     }
 
     /**
@@ -104,25 +243,48 @@ public:
      * the appropriately promoted vector of value pointers are returned.
      */
     [[nodiscard]] std::pair<T, Values> resolve(const Values &args) {
-        for (auto overload = overloads.rbegin(); overload != overloads.rend(); ++overload) {
-            if (overload->num_params() != args.size()) {
-                continue;
+        auto signature = signature_of(args);
+
+        // Fast path: an argument list with the same signature has already been resolved
+        std::optional<std::optional<std::size_t>> memoized{};
+        if (signature.has_value()) {
+            std::shared_lock lock{ resolutions_mutex };
+            if (auto entry = resolutions.find(*signature); entry != resolutions.end()) {
+                memoized.emplace(entry->second);
+            }
+        }
+        if (memoized.has_value()) {
+            if (!memoized->has_value()) {
+                throw OverloadResolutionFailure{};
             }
-            Values promoted_args;
-            bool ok = true;
-            for (size_t i = 0; i < args.size(); i++) {
-                auto promoted_arg = promote(args.at(i), overload->param_type_at(i));
-                if (promoted_arg.empty()) {
-                    ok = false;
+            const auto &overload = overloads[**memoized];
+            if (auto promoted_args = promote_args(overload, args)) {
+                return std::pair<T, Values>(overload.get_tag(), std::move(*promoted_args));
+            }
+        }
+
+        // Slow path: try the overloads with the right number of parameters, last added first
+        std::optional<std::size_t> resolution{};
+        std::optional<Values> promoted_args{};
+        if (auto entry = overloads_by_arity.find(args.size()); entry != overloads_by_arity.end()) {
+            for (auto index : entry->second) {
+                if ((promoted_args = promote_args(overloads[index], args))) {
+                    resolution = index;
                     break;
                 }
-                promoted_args.add(promoted_arg);
             }
-            if (ok) {
-                return std::pair<T, Values>(overload->get_tag(), promoted_args);
+        }
+        if (signature.has_value()) {
+            std::unique_lock lock{ resolutions_mutex };
+            if (resolutions.size() >= max_memoized_resolutions) {
+                resolutions.clear();
             }
+            resolutions.insert_or_assign(*signature, resolution);
+        }
+        if (!resolution.has_value()) {
+            throw OverloadResolutionFailure{};
         }
-        throw OverloadResolutionFailure{};
+        return std::pair<T, Values>(overloads[*resolution].get_tag(), std::move(*promoted_args));
     }
 };
 
@@ -132,22 +294,23 @@ public:
 //----------------------//
 
 /**
- * Table of overloaded callables with case-sensitive identifier matching.
+ * Table of overloaded callables.
  * T is the tag type of the callable/overload pair.
+ * Identifiers are matched according to Hash and KeyEqual, i.e. case-sensitively by default.
  */
-template <class T, class TypeBase, class Node>
+template <class T, class TypeBase, class Node,
+    class Hash = std::hash<std::string>, class KeyEqual = std::equal_to<std::string>>
 class OverloadedNameResolver {
     using Type = tree::One<TypeBase>;
     using Types = tree::Any<TypeBase>;
     using Value = tree::One<Node>;
     using Values = tree::Any<Node>;
 
-    std::unordered_map<std::string, OverloadResolver<T, TypeBase, Node>> table;
+    std::unordered_map<std::string, OverloadResolver<T, TypeBase, Node>, Hash, KeyEqual> table;
 
 public:
     /**
      * Registers a callable.
-     * Matching will be done case-sensitively.
      * The param_types variadic specifies the amount and types of the parameters that
      * (this particular overload of) the function expects.
      * The C++ implementation of the function can assume that
@@ -166,7 +329,7 @@ public:
     }
 
     /**
-     * Resolves the particular overload for the callable with the given case-sensitively matched name.
+     * Resolves the particular overload for the callable with the given name.
      * Raises NameResolutionFailure if no callable with the requested name is found,
      * raises an OverloadResolutionFailure if overload resolution fails, or otherwise
      * returns the tag of the first applicable callable/overload pair and
@@ -0,0 +1,22 @@
+/** \file
+ * Conversion of parse and analysis results to the result returned by the Python interface.
+ * Unlike cqasm-py-result.hpp, this header is not seen by SWIG, and is shared by the v1x and v3x Python interfaces.
+ */
+
+#pragma once
+
+#include "cqasm-py-result.hpp"
+#include "cqasm-result.hpp"
+
+
+namespace cqasm::result {
+
+/**
+ * Converts a ParseResult or an AnalysisResult to a PyResult.
+ */
+template <typename Result>
+PyResult to_py_result(const Result &result) {
+    return PyResult{ to_cbor(result), to_error_messages(result) };
+}
+
+}  // namespace cqasm::result
@@ -0,0 +1,28 @@
+/** \file
+ * Defines the result returned by the parse and analyze methods of the Python interface.
+ * As for the rest of the internal Python interface, this header doesn't include any libqasm header.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+
+/**
+ * Result of parsing or analyzing a cQASM program, as returned to Python.
+ * Notice that the tree and the errors won't be available at the same time.
+ */
+struct PyResult {
+    /**
+     * CBOR serialization of the syntactic or semantic tree, empty if there are errors.
+     * SWIG does not expose this member directly, as it would convert it to a str,
+     * but through a tree_bytes() method, returning a bytes object (see libQasm.i).
+     */
+    std::string tree;
+
+    /**
+     * Error messages.
+     */
+    std::vector<std::string> errors;
+};
@@ -32,6 +32,27 @@ std::vector<std::string> to_strings(const Result &result) {
     return ret;
 }
 
+/**
+ * Returns the CBOR serialization of the syntactic or semantic AST, or an empty string if there are errors.
+ */
+template <typename Result>
+std::string to_cbor(const Result &result) {
+    return result.errors.empty()
+        ? ::tree::base::serialize(result.root)
+        : std::string{};
+}
+
+/**
+ * Returns the error messages.
+ */
+template <typename Result>
+std::vector<std::string> to_error_messages(const Result &result) {
+    auto ret = std::vector<std::string>(result.errors.size());
+    std::transform(result.errors.begin(), result.errors.end(), ret.begin(),
+        [](const auto &error) { return error.what(); });
+    return ret;
+}
+
 template <typename Errors>
 std::string errors_to_json(const Errors &errors) {
     return fmt::format(R"({{"errors":[{0}]}})",
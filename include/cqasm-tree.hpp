@@ -7,6 +7,10 @@
 #include "tree-annotatable.hpp"
 #include "tree-base.hpp"
 
+#include <cstddef>  // size_t
+#include <memory>  // allocate_shared, make_shared, shared_ptr
+#include <memory_resource>  // monotonic_buffer_resource
+
 
 /**
  * Namespace for wrapping tree-gen's support library.
@@ -36,12 +40,107 @@ using Link = ::tree::base::Link<T>;
 template <class T>
 using OptLink = ::tree::base::OptLink<T>;
 
+/**
+ * Arena that tree nodes can be allocated from, instead of each node being a separate heap allocation.
+ * Allocation is monotonic: the memory of the nodes is only released, in one go, when the arena is destroyed.
+ * The nodes do not keep the arena alive, so whoever owns the arena must keep it alive for as long as its nodes,
+ * e.g. an AnalysisResult owns the arena of the tree it holds.
+ * An arena is not thread-safe, so it must not be current on more than one thread at a time.
+ */
+class Arena : public std::pmr::monotonic_buffer_resource {
+public:
+    using std::pmr::monotonic_buffer_resource::monotonic_buffer_resource;
+};
+
+/**
+ * Allocator for std::allocate_shared, allocating from an arena.
+ * It only holds a pointer to the arena, so that a node does not pay for a reference count on it.
+ */
+template <class T>
+class ArenaAllocator {
+    template <class U> friend class ArenaAllocator;
+
+    Arena *arena_;
+
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(Arena *arena) noexcept : arena_{ arena } {}
+
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U> &other) noexcept : arena_{ other.arena_ } {}
+
+    T *allocate(std::size_t n) {
+        return static_cast<T *>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept {
+        arena_->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    template <class U>
+    bool operator==(const ArenaAllocator<U> &other) const noexcept { return arena_ == other.arena_; }
+};
+
+/**
+ * Returns the arena that make() allocates from on the current thread, if any.
+ */
+inline Arena *&current_arena() {
+    static thread_local Arena *arena{};
+    return arena;
+}
+
+/**
+ * Makes the given arena the one that make() allocates from on the current thread,
+ * for the lifetime of this object.
+ * The previously current arena, if any, is restored afterwards.
+ */
+class ArenaScope {
+    Arena *previous_;
+
+public:
+    explicit ArenaScope(Arena &arena) : previous_{ current_arena() } {
+        current_arena() = &arena;
+    }
+    ~ArenaScope() { current_arena() = previous_; }
+
+    ArenaScope(const ArenaScope &other) = delete;
+    ArenaScope &operator=(const ArenaScope &other) = delete;
+};
+
 /**
  * Constructs a One object, analogous to std::make_shared.
+ * The object is allocated from the current arena, if any.
  */
 template <class T, typename... Args>
 One<T> make(Args... args) {
+    if (auto *arena = current_arena()) {
+        return One<T>(std::allocate_shared<T>(ArenaAllocator<T>{ arena }, args...));
+    }
     return One<T>(std::make_shared<T>(args...));
 }
 
+/**
+ * Constructs a Many object of count default-constructed T objects, analogous to std::make_shared<T[]>.
+ * The objects are stored packed, in a single allocation shared by all the elements,
+ * instead of each being a separate heap allocation.
+ * The allocation is taken from the current arena, if any.
+ */
+template <class T>
+Many<T> make_many(std::size_t count) {
+    std::shared_ptr<T[]> block{};
+    if (auto *arena = current_arena()) {
+        block = std::allocate_shared<T[]>(ArenaAllocator<T>{ arena }, count);
+    } else {
+        block = std::make_shared<T[]>(count);
+    }
+    Many<T> ret{};
+    auto &elements = ret.get_vec();
+    elements.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        elements.emplace_back(std::shared_ptr<T>(block, &block[i]));
+    }
+    return ret;
+}
+
 } // namespace cqasm::tree
@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <cstddef>  // size_t
 #include <string>
+#include <string_view>
 
 
 /**
@@ -20,7 +22,29 @@ std::string to_lowercase(const std::string &name);
 /**
  * Case-insensitive string compare.
  */
-bool equal_case_insensitive(const std::string &lhs, const std::string &rhs);
+bool equal_case_insensitive(std::string_view lhs, std::string_view rhs);
+
+/**
+ * Case-insensitive string hash, consistent with equal_case_insensitive.
+ * It hashes the lowercase form of the string without building it,
+ * so that case-insensitive unordered containers can be searched without allocating.
+ */
+struct CaseInsensitiveHash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view str) const noexcept;
+};
+
+/**
+ * Case-insensitive string equality, to be used together with CaseInsensitiveHash.
+ */
+struct CaseInsensitiveEqual {
+    using is_transparent = void;
+
+    bool operator()(std::string_view lhs, std::string_view rhs) const noexcept {
+        return equal_case_insensitive(lhs, rhs);
+    }
+};
 
 /**
  * Encodes a string in URL format.
@@ -32,4 +56,10 @@ std::string url_encode(const std::string &str);
  */
 std::string json_encode(const std::string &str);
 
+/**
+ * Reads the whole contents of a file into a string.
+ * Throws a ParseError if the file cannot be read.
+ */
+std::string read_file(const std::string &file_path);
+
 } // namespace cqasm::utils
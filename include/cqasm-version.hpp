@@ -6,13 +6,18 @@
 
 #include "cqasm-error.hpp"
 
+#include <array>
+#include <cstddef>  // size_t
 #include <cstdint>  // int64_t
 #include <cstdio>  // FILE*
 #include <fmt/ostream.h>
 #include <memory>  // unique_ptr
 #include <optional>
 #include <ostream>
+#include <span>
+#include <stdexcept>  // invalid_argument
 #include <string>
+#include <string_view>
 #include <vector>
 
 
@@ -21,20 +26,57 @@
  */
 namespace cqasm::version {
 
+/**
+ * Version number known at compile time, e.g. the version of the language that introduced a feature.
+ * The string it is constructed from is parsed by the compiler,
+ * so comparing a Version against it neither parses a string nor allocates.
+ */
+class VersionLiteral {
+    std::array<std::int64_t, 4> components_{};
+    std::size_t size_{ 0 };
+
+public:
+    /**
+     * Constructs a version literal from a string made of up to 4 dot-separated numbers, e.g. "1.2".
+     * A malformed string fails to compile.
+     */
+    consteval explicit VersionLiteral(const char *version) {
+        for (const char *c = version; ; ++c) {
+            if (*c < '0' || *c > '9' || size_ == components_.size()) {
+                throw std::invalid_argument("malformed version literal");
+            }
+            auto &component = components_[size_++];
+            for (; *c >= '0' && *c <= '9'; ++c) {
+                component = component * 10 + (*c - '0');
+            }
+            if (*c == '\0') {
+                break;
+            }
+            if (*c != '.') {
+                throw std::invalid_argument("malformed version literal");
+            }
+        }
+    }
+
+    [[nodiscard]] constexpr std::span<const std::int64_t> components() const {
+        return { components_.data(), size_ };
+    }
+};
+
 /**
  * Version number primitive used within the AST and semantic trees.
  */
 class Version : public std::vector<std::int64_t> {
 private:
     /**
-     * Compares this version against the other version.
+     * Compares this version against the other version, given by its components.
      * Returns:
      *   1 if this version is newer than the other,
      *   -1 if this version is older than the other, or
      *   0 if both versions are the same.
      * When there is a mismatch in the number of components between the versions, missing components are interpreted as 0.
      */
-    [[nodiscard]] int compare(const Version &other) const;
+    [[nodiscard]] int compare(std::span<const std::int64_t> other) const;
 
 public:
     /**
@@ -58,6 +100,12 @@ public:
     [[nodiscard]] auto operator<=>(const Version &rhs) const {
         return compare(rhs) <=> 0;
     }
+    [[nodiscard]] auto operator==(const VersionLiteral &rhs) const {
+        return compare(rhs.components()) == 0;
+    }
+    [[nodiscard]] auto operator<=>(const VersionLiteral &rhs) const {
+        return compare(rhs.components()) <=> 0;
+    }
 };
 
 /**
@@ -93,10 +141,25 @@ public:
 };
 
 
+/**
+ * Input of the version lexer when scanning from memory.
+ * The lexer pulls the data in chunks, on demand, so it is neither copied as a whole nor read past the version statement.
+ */
+struct StringInput {
+    std::string_view data;
+
+    /**
+     * Copies up to max_size bytes of the remaining data into buffer.
+     * Returns the number of bytes copied, 0 meaning end of input.
+     */
+    std::size_t read(char *buffer, std::size_t max_size);
+};
+
+
 class ScannerFlexBisonString : public ScannerFlexBison {
-    const char *data_{ nullptr };
+    std::string_view data_;
 public:
-    explicit ScannerFlexBisonString(const char *data);
+    explicit ScannerFlexBisonString(std::string_view data);
     ~ScannerFlexBisonString() override;
     void parse(const std::string &file_name, Version &version) const override;
 };
@@ -121,6 +184,12 @@ Version parse_file(FILE* fp, const std::optional<std::string> &file_name);
  */
 Version parse_string(const std::string &data, const std::optional<std::string> &file_name);
 
+/**
+ * Same as parse_string, but scans a caller-owned buffer, e.g. a memory-mapped file, without copying it.
+ * The data only has to stay alive for the duration of the call.
+ */
+Version parse_view(std::string_view data, const std::optional<std::string> &file_name);
+
 
 /**
  * Internal helper class for parsing cQASM file versions.
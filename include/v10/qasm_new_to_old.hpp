@@ -45,10 +45,10 @@ enum class ParameterType {
 /**
  * Converts a list of indices from the new API format to the old API format.
  */
-static NumericalIdentifiers convert_indices(const cqasm::tree::Many<cq1x::values::ConstInt> &indices) {
+static NumericalIdentifiers convert_indices(const cqasm::tree::Many<cq1x::values::IndexRange> &indices) {
     NumericalIdentifiers retval;
-    for (const auto &control_bit : indices) {
-        retval.addToVector(static_cast<int>(control_bit->value));
+    for (const auto &index : cq1x::values::expand_indices(indices)) {
+        retval.addToVector(static_cast<int>(index));
     }
     return retval;
 }
@@ -37,11 +37,62 @@ public:
      */
     std::list<std::pair<tree::Maybe<semantic::GotoInstruction>, std::string>> gotos;
 
+    /**
+     * Whether the semantic tree is built from extended bundles within blocks, i.e. the API version is 1.2+.
+     * Computed once, so that analyzing a statement does not compare versions.
+     */
+    bool api_has_bundle_ext;
+
+    /**
+     * Whether expressions may be dynamic, i.e. the API version is 1.1+.
+     */
+    bool api_has_dynamic_expressions;
+
+    /**
+     * Whether the program may declare variables, i.e. the file version is 1.1+.
+     * Set by analyze_version.
+     */
+    bool has_variables = false;
+
+    /**
+     * Whether the program may use structured control-flow, i.e. the file version is 1.2+.
+     * Set by analyze_version.
+     */
+    bool has_structured_control_flow = false;
+
+    /**
+     * Callback receiving the analyzed bundles instead of their subcircuit, when streaming (API 1.0/1.1).
+     */
+    BundleCallback bundle_callback;
+
+    /**
+     * Whether a bundle has been handed to the bundle callback.
+     */
+    bool has_streamed_bundles = false;
+
+    /**
+     * Prepares the analysis of a program using the given analyzer,
+     * handing the analyzed bundles to the given callback, if any, instead of adding them to their subcircuit.
+     */
+    explicit AnalyzerHelper(const Analyzer &analyzer, BundleCallback bundle_callback = {});
+
     /**
      * Analyzes the given AST using the given analyzer.
      */
     AnalyzerHelper(const Analyzer &analyzer, const ast::Program &ast);
 
+    /**
+     * Analyzes the version and qubits statements, which precede all the other statements of the program.
+     * Throws an AnalysisError if the rest of the program cannot be analyzed.
+     */
+    void analyze_header(const ast::Version &version, const ast::Expression *num_qubits);
+
+    /**
+     * Finishes the analysis once all the statements of the program have been analyzed,
+     * resolving the goto targets (1.2+) and saving the global mappings into the program.
+     */
+    void analyze_end();
+
     /**
      * Parses the version tag.
      * Any semantic errors encountered are pushed into the result error vector.
@@ -86,6 +137,13 @@ public:
      */
     void analyze_statements(const ast::StatementList &statements);
 
+    /**
+     * Analyzes the given statement,
+     * adding the analyzed statement to the current subcircuit (API 1.0/1.1) or block (API 1.2+).
+     * If an error occurs, the message is added to the result error vector, and nothing is added.
+     */
+    void analyze_statement(const ast::Statement &statement);
+
     /**
      * Analyzes a statement list corresponding to a structured control-flow subblock (1.2+).
      * Handles the requisite scoping, then defers to analyze_statements().
@@ -93,7 +151,8 @@ public:
     tree::Maybe<semantic::Block> analyze_subblock(const ast::StatementList &statements, bool is_loop);
 
     /**
-     * Analyzes the given bundle and, if valid, adds it to the current subcircuit using API version 1.0/1.1.
+     * Analyzes the given bundle and, if valid, adds it to the current subcircuit using API version 1.0/1.1,
+     * or hands it to the bundle callback when streaming.
      * If an error occurs, the message is added to the result error vector, and nothing is added to the subcircuit.
      */
     void analyze_bundle(const ast::Bundle &bundle);
@@ -262,9 +321,10 @@ public:
     values::Value analyze_index(const ast::Index &index);
 
     /**
-     * Parses an index list.
+     * Parses an index list into ranges of positions, checking that they are in
+     * range of a list of the given size.
      */
-    tree::Many<values::ConstInt> analyze_index_list(
+    tree::Many<values::IndexRange> analyze_index_list(
         const ast::IndexList &index_list, size_t size);
 
     /**
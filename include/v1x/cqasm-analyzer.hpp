@@ -26,6 +26,16 @@
  */
 namespace cqasm::v1x::analyzer {
 
+/**
+ * Callback receiving the bundles of a program analyzed in streaming mode, see Analyzer::analyze_stream().
+ * It is called for every bundle, in program order, with the program and the subcircuit the bundle belongs to.
+ * The program only holds what has been analyzed so far, and its subcircuits hold no bundles.
+ */
+using BundleCallback = std::function<void(
+    const semantic::Program &program,
+    const semantic::Subcircuit &subcircuit,
+    tree::One<semantic::Bundle> bundle)>;
+
 /**
  * Main class used for analyzing cQASM files.
  *
@@ -268,6 +278,46 @@ public:
      * The optional file_name argument will be used only for error messages.
      */
     AnalysisResult analyze_string(const std::string &data, const std::optional<std::string> &file_name);
+
+    /**
+     * Parses and analyzes in streaming mode using the given version and parser closures,
+     * for programs too large to be held in memory, such as long traces.
+     * The parser closure must parse in streaming mode, handing the statements to the given stream.
+     * Every statement is analyzed as soon as it is parsed, and the resulting bundles are handed to the callback
+     * instead of being added to their subcircuit, so that neither the AST nor the semantic tree
+     * grow with the size of the program.
+     * The returned program only holds the version, number of qubits, error model, and mappings,
+     * and the subcircuits without their bundles.
+     * The version, number of qubits, and error model are resolved before the first bundle is handed over,
+     * so the error model must be specified before it.
+     * Only the bundle-based semantic tree of API versions 1.0 and 1.1 can be streamed.
+     * Errors are returned as usual, but the bundles preceding an error may have been handed over already.
+     */
+    AnalysisResult analyze_stream(
+        const std::function<version::Version()> &version_parser,
+        const std::function<parser::ParseResult(const parser::StatementStream &)> &parser,
+        const BundleCallback &callback);
+
+    /**
+     * Parses and analyzes the given file in streaming mode, see analyze_stream().
+     */
+    AnalysisResult analyze_stream_file(const std::string &file_name, const BundleCallback &callback);
+
+    /**
+     * Parses and analyzes the given string in streaming mode, see analyze_stream().
+     * The optional file_name argument will be used only for error messages.
+     */
+    AnalysisResult analyze_stream_string(
+        const std::string &data,
+        const std::optional<std::string> &file_name,
+        const BundleCallback &callback);
+
+private:
+    /**
+     * Checks the version returned by the given version parser against the API version.
+     * Returns whether the file can be analyzed, pushing an error into the given result otherwise.
+     */
+    bool check_file_version(const std::function<version::Version()> &version_parser, AnalysisResult &result) const;
 };
 
 } // namespace cqasm::v1x::analyzer
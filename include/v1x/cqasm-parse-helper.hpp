@@ -10,8 +10,14 @@
 #include "cqasm-ast.hpp"
 #include "cqasm-parse-result.hpp"
 
+#include <array>
+#include <cstddef>  // size_t
 #include <cstdio>
+#include <functional>
+#include <memory_resource>
 #include <optional>
+#include <string_view>
+#include <unordered_set>
 
 
 /**
@@ -40,47 +46,172 @@ ParseResult parse_file(FILE* fp, const std::optional<std::string> &file_name);
 ParseResult parse_string(const std::string &data, const std::optional<std::string> &file_name);
 
 /**
- * Internal helper class for parsing cQASM files.
+ * Same as parse_string, but scans a caller-owned buffer, e.g. a memory-mapped file, without copying it.
+ * The data only has to stay alive for the duration of the call.
  */
-class ParseHelper {
+ParseResult parse_view(std::string_view data, const std::optional<std::string> &file_name);
+
+/**
+ * Receiver of the statements of a program parsed in streaming mode, see parse_stream().
+ */
+struct StatementStream {
+    /**
+     * Called once with the version and the qubits statement, if any, of the program,
+     * before the first statement of the program is handed to statement.
+     */
+    std::function<void(const ast::Version &version, const ast::Expression *num_qubits)> header;
+
+    /**
+     * Called for every statement at the top level of the program, in program order.
+     * The statement, including any block it opens, is dropped when this returns.
+     */
+    std::function<void(const ast::Statement &statement)> statement;
+};
+
+/**
+ * Same as parse_view, but hands the statements at the top level of the program to the given stream
+ * as soon as they are parsed, and drops them afterwards, instead of adding them to the AST.
+ * The memory used by the parser is then bounded by the size of the largest statement,
+ * rather than that of the program.
+ * Nothing is handed to the stream anymore once a parse error is found.
+ */
+ParseResult parse_stream(
+    std::string_view data,
+    const std::optional<std::string> &file_name,
+    const StatementStream &stream);
+
+/**
+ * Per-parse storage for the text of the tokens returned by the lexer.
+ * The lexer copies the text of every token that has one into a monotonic buffer,
+ * instead of allocating a string per token, and interns identifiers,
+ * so that repeated names are stored only once.
+ * All the strings handed out stay valid until this object is destroyed,
+ * or, for the ones returned by store(), until they are recycled.
+ */
+class TokenStrings {
+    std::pmr::monotonic_buffer_resource buffer_;
+    std::pmr::unordered_set<std::string_view> interned_{ &buffer_ };
+    std::array<std::pmr::monotonic_buffer_resource, 2> stored_;
+    std::size_t current_ = 0;
+
 public:
     /**
-     * File pointer being scanned, if no data was specified.
+     * Constructs an empty store, whose buffers allocate their memory from the given upstream resource.
+     */
+    explicit TokenStrings(std::pmr::memory_resource *upstream = std::pmr::get_default_resource());
+    TokenStrings(const TokenStrings &other) = delete;
+    TokenStrings &operator=(const TokenStrings &other) = delete;
+
+    /**
+     * Returns a null-terminated copy of the given text.
+     */
+    const char *store(std::string_view text);
+
+    /**
+     * Returns a null-terminated copy of the given text,
+     * which is the same for all the calls with an equal text.
+     */
+    const char *intern(std::string_view text);
+
+    /**
+     * Releases the strings returned by store() before the previous call to this function.
+     * A streaming parse calls this after every statement, at which point only the text of the lookahead token,
+     * stored after the previous statement, may still be in use.
+     */
+    void recycle();
+};
+
+/**
+ * State of a parse that the scanner accesses, as the extra data of the flex scanner.
+ */
+struct ScannerContext {
+    /**
+     * Text of the tokens.
+     */
+    TokenStrings token_strings;
+
+    /**
+     * Part of the input that the scanner has not read yet, if it scans a buffer rather than a file.
      */
-    FILE *fptr = nullptr;
+    std::optional<std::string_view> input;
 
     /**
-     * Flex data buffer, if data was specified.
+     * Copies up to max_size bytes of the input into buffer, on behalf of the YY_INPUT macro of the scanner.
+     * The input is taken from the input view if set, and otherwise read from the given file.
+     * Returns the number of bytes copied, which is 0 at the end of the input.
      */
-    void *buf = nullptr;
+    std::size_t read(char *buffer, std::size_t max_size, FILE *file);
+};
 
+/**
+ * Internal helper class for parsing cQASM files.
+ */
+class ParseHelper {
+public:
     /**
      * Flex reentrant scanner data.
      */
     void *scanner = nullptr;
 
+    /**
+     * State of the parse that the scanner accesses.
+     */
+    ScannerContext scanner_context;
+
     /**
      * Name of the file being parsed.
      */
     std::string file_name;
 
+    /**
+     * Name of the file being parsed, constructed once per parse and shared by all the source locations.
+     */
+    std::optional<annotations::FileName> shared_file_name;
+
     /**
      * The parse result.
      */
     ParseResult result;
 
+    /**
+     * The stream the statements are handed to, if parsing in streaming mode.
+     */
+    const StatementStream *stream = nullptr;
+
+    /**
+     * Version and qubits statement of the program, set by the parser as soon as they are parsed,
+     * for the header of the stream.
+     * They are owned by the parser stack, and then by the program node.
+     */
+    const ast::Version *header_version = nullptr;
+    const ast::Expression *header_num_qubits = nullptr;
+
+    /**
+     * Whether the header has been handed to the stream.
+     */
+    bool header_streamed = false;
+
 private:
     friend ParseResult parse_file(const std::string &file_path);
     friend ParseResult parse_file(FILE* fp, const std::optional<std::string> &file_name);
-    friend ParseResult parse_string(const std::string &data, const std::optional<std::string> &file_name);
+    friend ParseResult parse_view(std::string_view data, const std::optional<std::string> &file_name);
+    friend ParseResult parse_stream(
+        std::string_view data,
+        const std::optional<std::string> &file_name,
+        const StatementStream &stream);
 
     /**
      * Parse a string or file with flex/bison.
-     * If use_file is set, the file specified by file_path is read and data is ignored.
-     * Otherwise, file_path is used only for error messages, and data is read instead.
+     * If use_file is set, the file specified by file_path is mapped and scanned, and data is ignored.
+     * Otherwise, file_path is used only for error messages, and data is scanned instead.
+     * The statements are handed to the given stream, if any, instead of being added to the AST.
      * Don't use this directly, use parse().
      */
-    ParseHelper(const std::optional<std::string> &file_path, const std::string &data, bool use_file);
+    ParseHelper(
+        const std::optional<std::string> &file_path,
+        std::string_view data,
+        bool use_file,
+        const StatementStream *statement_stream = nullptr);
 
     /**
      * Construct the analyzer internals for the given file_name, and analyze the file.
@@ -112,6 +243,19 @@ public:
      * Builds and pushes an error.
      */
     void push_error(const std::string &message, const annotations::SourceLocation::Range &range);
+
+    /**
+     * Adds a statement at the top level of the program to the given list.
+     * In streaming mode, the statement is instead handed to the stream, after the header if it's the first one,
+     * and then dropped.
+     */
+    void add_statement(ast::StatementList &list, ast::Statement *statement);
+
+private:
+    /**
+     * Hands the header of the program to the stream, unless this was done already.
+     */
+    void stream_header();
 };
 
 } // namespace cqasm::v1x::parser
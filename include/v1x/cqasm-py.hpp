@@ -9,6 +9,8 @@
 // Don't include any libqasm headers!
 // We don't want SWIG to generate Python wrappers for the entire world.
 // Those headers are only included in the source file that provides the implementations.
+#include "cqasm-py-result.hpp"
+
 #include <memory>
 #include <string>
 #include <vector>
@@ -22,6 +24,10 @@ namespace cqasm::v1x::analyzer {
 
 /**
  * Main class for parsing and analyzing cQASM files with the v1.x API.
+ *
+ * The parse and analyze methods can be called concurrently on the same object,
+ * since analyses only read the analyzer. They release the Python GIL while running.
+ * The register methods, however, must not be called while analyses are in progress.
  */
 class V1xAnalyzer {
     /**
@@ -72,11 +78,9 @@ public:
      * Only parses the given file.
      * The file must be in v1.x syntax.
      * No version check or conversion is performed.
-     * Returns a vector of strings, of which the first is reserved for the CBOR serialization of the v1.x AST.
-     * Any additional strings represent error messages.
-     * Notice that the AST and error messages won't be available at the same time.
+     * Returns a PyResult with either the CBOR serialization of the v1.x AST, or the error messages.
      */
-    static std::vector<std::string> parse_file(const std::string &file_name);
+    static PyResult parse_file(const std::string &file_name);
 
     /**
      * Counterpart of parse_file that returns a string with a JSON representation of the ParseResult.
@@ -87,7 +91,7 @@ public:
      * Same as parse_file(), but instead receives the file contents directly.
      * The file_name, if specified, is only used when reporting errors.
      */
-    static std::vector<std::string> parse_string(const std::string &data, const std::string &file_name = "");
+    static PyResult parse_string(const std::string &data, const std::string &file_name = "");
 
     /**
      * Counterpart of parse_string that returns a string with a JSON representation of the ParseResult.
@@ -99,11 +103,9 @@ public:
      * If the file is written in a later file version,
      * this function may try to reduce it to the maximum v1.x API version support advertised
      * using this object's constructor.
-     * Returns a vector of strings, of which the first is reserved for the CBOR serialization of the v1.x semantic tree.
-     * Any additional strings represent error messages.
-     * Notice that the AST and error messages won't be available at the same time.
+     * Returns a PyResult with either the CBOR serialization of the v1.x semantic tree, or the error messages.
      */
-    std::vector<std::string> analyze_file(const std::string &file_name) const;
+    PyResult analyze_file(const std::string &file_name) const;
 
     /**
      * Counterpart of analyze_file that returns a string with a JSON representation of the AnalysisResult.
@@ -114,7 +116,7 @@ public:
      * Same as analyze_file(), but instead receives the file contents directly.
      * The file_name, if specified, is only used when reporting errors.
      */
-    std::vector<std::string> analyze_string(const std::string &data, const std::string &file_name = "") const;
+    PyResult analyze_string(const std::string &data, const std::string &file_name = "") const;
 
     /**
      * Counterpart of analyze_string that returns a string with a JSON representation of the AnalysisResult.
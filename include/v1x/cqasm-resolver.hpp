@@ -12,11 +12,13 @@
 #include "cqasm-instruction.hpp"
 #include "cqasm-overload.hpp"
 #include "cqasm-semantic.hpp"
+#include "cqasm-utils.hpp"
 
 #include <algorithm>
 #include <fmt/format.h>
 #include <functional>
 #include <memory>
+#include <unordered_map>
 
 
 /**
@@ -34,17 +36,26 @@ CQASM_ANALYSIS_ERROR(NameResolutionFailure);
  */
 CQASM_ANALYSIS_ERROR(OverloadResolutionFailure);
 
+/**
+ * Table of overloaded callables.
+ * For v1, names are matched case-insensitively, without building their lowercase form.
+ */
 template <class T>
-struct OverloadedNameResolver : public cqasm::overload::OverloadedNameResolver<T, types::TypeBase, values::Node> {
+struct OverloadedNameResolver : public cqasm::overload::OverloadedNameResolver<T, types::TypeBase, values::Node,
+    utils::CaseInsensitiveHash, utils::CaseInsensitiveEqual> {
+
+    using Base = cqasm::overload::OverloadedNameResolver<T, types::TypeBase, values::Node,
+        utils::CaseInsensitiveHash, utils::CaseInsensitiveEqual>;
+
     virtual ~OverloadedNameResolver() = default;
 
     void add_overload(const std::string &name, const T &tag, const types::Types &param_types) override {
-        cqasm::overload::OverloadedNameResolver<T, types::TypeBase, values::Node>::add_overload(name, tag, param_types);
+        Base::add_overload(name, tag, param_types);
     }
 
     [[nodiscard]] std::pair<T, values::Values> resolve(const std::string &name, const values::Values &args) override {
         try {
-            return cqasm::overload::OverloadedNameResolver<T, types::TypeBase, values::Node>::resolve(name, args);
+            return Base::resolve(name, args);
         } catch (const cqasm::overload::NameResolutionFailure &) {
             throw NameResolutionFailure{ "failed to resolve " + name };
         } catch (const cqasm::overload::OverloadResolutionFailure &) {
@@ -59,9 +70,33 @@ struct OverloadedNameResolver : public cqasm::overload::OverloadedNameResolver<T
  * Table of all mappings within a certain scope.
  */
 class MappingTable {
-    std::unordered_map<std::string, std::pair<const values::Value, tree::Maybe<ast::Mapping>>> table;
+public:
+    /**
+     * Mappings by lowercase name.
+     * Names are looked up case-insensitively, without building their lowercase form.
+     */
+    using Table = std::unordered_map<std::string, std::pair<const values::Value, tree::Maybe<ast::Mapping>>,
+        utils::CaseInsensitiveHash, utils::CaseInsensitiveEqual>;
+
+private:
+    Table table;
+
+    /**
+     * The table of the enclosing scope, if any.
+     * Names that are not mapped in this table are resolved in the parent table.
+     */
+    const MappingTable *parent = nullptr;
 
 public:
+    MappingTable() = default;
+
+    /**
+     * Creates an empty table for a scope nested within that of the given parent table.
+     * Only the mappings added to the new table are stored in it,
+     * the parent table is not copied, so it must outlive the new table.
+     */
+    explicit MappingTable(const MappingTable *parent);
+
     /**
      * Adds a mapping.
      */
@@ -72,14 +107,16 @@ public:
     );
 
     /**
-     * Resolves a mapping. Throws NameResolutionFailure if no mapping by the given name exists.
+     * Resolves a mapping, in this table first, and then in the parent tables.
+     * Throws NameResolutionFailure if no mapping by the given name exists.
      */
     [[nodiscard]] values::Value resolve(const std::string &name) const;
 
     /**
      * Grants read access to the underlying map.
+     * This only contains the mappings added to this table, not those of the parent tables.
      */
-    const std::unordered_map<std::string, std::pair<const values::Value, tree::Maybe<ast::Mapping>>> &get_table() const;
+    const Table &get_table() const;
 };
 
 /**
@@ -13,18 +13,22 @@ namespace cqasm::v1x::analyzer {
 struct Scope {
     /**
      * The mappings visible within this scope.
+     * Only the mappings added within this scope are stored here,
+     * the ones of the enclosing scopes are resolved through the parent table.
      */
     resolver::MappingTable mappings;
 
     /**
      * The functions visible within this scope.
+     * These never change during an analysis, so all the scopes share the table of the analyzer.
      */
-    resolver::FunctionTable functions;
+    const resolver::FunctionTable &functions;
 
     /**
      * The instruction set visible within this scope.
+     * This never changes during an analysis, so all the scopes share the table of the analyzer.
      */
-    resolver::InstructionTable instruction_set;
+    const resolver::InstructionTable &instruction_set;
 
     /**
      * The block associated with this scope, if any.
@@ -42,11 +46,18 @@ struct Scope {
 
     /**
      * Creates a scope from a table of mappings, functions, and an instruction set.
+     * The function table and the instruction set are not copied, so they must outlive the scope.
      */
     Scope(
         resolver::MappingTable mappings,
-        resolver::FunctionTable functions,
-        resolver::InstructionTable instruction_set);
+        const resolver::FunctionTable &functions,
+        const resolver::InstructionTable &instruction_set);
+
+    /**
+     * Creates the scope of a block nested within the given parent scope.
+     * Nothing is copied from the parent scope, which must outlive the new scope.
+     */
+    Scope(const Scope &parent, tree::Maybe<semantic::Block> block, bool is_loop);
 };
 
 } // namespace cqasm::v1x::analyzer
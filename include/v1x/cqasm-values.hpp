@@ -7,11 +7,14 @@
 #pragma once
 
 #include "cqasm-ast.hpp"
+#include "cqasm-overload.hpp"
 #include "cqasm-types.hpp"
 #include "v1x/cqasm-values-gen.hpp"
 
 #include <fmt/format.h>
 #include <fmt/ostream.h>
+#include <string>
+#include <vector>
 
 
 /**
@@ -39,6 +42,13 @@ using Values = tree::Any<Node>;
  */
 Value promote(const Value &value, const types::Type &type);
 
+/**
+ * Returns a key identifying the given value as far as promotion is concerned:
+ * values with the same key can be promoted to exactly the same types.
+ * Used to memoize overload resolutions.
+ */
+cqasm::overload::PromotionKey promotion_key(const Value &value);
+
 /**
  * Returns the type of the given value.
  */
@@ -61,6 +71,17 @@ void check_const(const Value &value);
  */
 void check_const(const Values &values);
 
+/**
+ * Returns the number of indices in the given index ranges.
+ */
+primitives::Int size_of(const tree::Many<IndexRange> &indices);
+
+/**
+ * Returns the individual indices in the given index ranges, in order.
+ * Index ranges are only expanded on demand, by the consumers that need every single index.
+ */
+std::vector<primitives::Int> expand_indices(const tree::Many<IndexRange> &indices);
+
 /**
  * Stream << overload for a single value.
  */
@@ -1,18 +1,21 @@
 #pragma once
 
+#include "v3x/ConstantFolder.hpp"
 #include "v3x/cqasm-analyzer.hpp"
 #include "v3x/cqasm-ast-gen.hpp"
 #include "v3x/cqasm-semantic-gen.hpp"
 
 #include <any>
+#include <optional>
 #include <string_view>
 #include <tuple>
 #include <utility>  // pair
+#include <vector>
 
 
 namespace cqasm::v3x::analyzer {
 
-using IndexT = values::ConstInt;
+using IndexT = values::IndexRange;
 using IndexListT = tree::Many<IndexT>;
 
 using GlobalBlockReturnT = std::tuple<
@@ -29,6 +32,11 @@ protected:
     Analyzer &analyzer_;
     AnalysisResult result_;
 
+    /**
+     * Folds constant expressions, when the analyzer configuration allows it.
+     */
+    std::optional<ConstantFolder> constant_folder_;
+
 public:
     explicit AnalyzeTreeGenAstVisitor(Analyzer &analyzer);
 
@@ -133,12 +141,13 @@ private:
     static tree::One<ConstTypeArray> build_array_value_from_promoted_values(
         const values::Values &values, const types::Type &type) {
 
-        auto ret = tree::make<ConstTypeArray>();
-        ret->value.get_vec().resize(values.size());
-        std::transform(values.begin(), values.end(), ret->value.begin(),
+        std::vector<values::Value> promoted_values(values.size());
+        std::transform(values.begin(), values.end(), promoted_values.begin(),
            [&type](const auto const_value) {
                 return values::promote(const_value, type);
         });
+        auto ret = tree::make<ConstTypeArray>();
+        values::assign_packed(ret->value, promoted_values);
         return ret;
     }
 
@@ -173,6 +182,12 @@ private:
         const tree::One<ast::Identifier> &name,
         const tree::Maybe<ast::ExpressionList> &arguments);
 
+    /**
+     * Resolves an identifier to the value shared with the variable tables,
+     * which must thus not be modified nor added to the tree
+     */
+    [[nodiscard]] values::Value resolve_identifier(ast::Identifier &node) const;
+
     /**
      * Convenience function for visiting unary operators
      */
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "cqasm-annotations.hpp"
 #include "v3x/BuildCustomAstVisitor.hpp"
 #include "v3x/CqasmParser.h"
 #include "v3x/CqasmParserVisitor.h"
@@ -16,9 +17,9 @@ namespace cqasm::v3x::parser {
 
 class BuildTreeGenAstVisitor : public BuildCustomAstVisitor {
     /**
-     * Name of the file being parsed.
+     * Name of the file being parsed, constructed once per parse and shared by all the source locations.
      */
-    std::optional<std::string> file_name_;
+    std::optional<annotations::FileName> file_name_;
 
     /**
      * Error listener.
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "v3x/cqasm-ast-gen.hpp"
+#include "v3x/cqasm-primitives.hpp"
+#include "v3x/cqasm-values.hpp"
+
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <variant>
+
+
+namespace cqasm::v3x::analyzer {
+
+class Analyzer;
+
+/**
+ * Evaluates constant operator and function call expressions of the AST directly on primitive values,
+ * producing only the final folded constant, instead of a value node per operator.
+ *
+ * It folds exactly what the default function implementations would:
+ * literals, and identifiers resolving to boolean, integer, or float constants,
+ * combined with the default operators and functions,
+ * using the same overload resolution order and promotion rules.
+ * Anything else, including expressions that would fail to analyze, is left to the generic analysis.
+ * It must thus only be used when the default function implementations have not been overridden,
+ * see AnalyzerConfig::folds_constants().
+ */
+class ConstantFolder : public ast::Visitor<std::optional<std::variant<primitives::Bool, primitives::Int, primitives::Float>>> {
+public:
+    /**
+     * A folded constant.
+     * The order of the alternatives is the promotion order: booleans promote to integers, and integers to floats.
+     */
+    using Constant = std::variant<primitives::Bool, primitives::Int, primitives::Float>;
+
+private:
+    const Analyzer &analyzer_;
+
+    /**
+     * Expressions that have already failed to fold, so that they are not tried again for each of their parents.
+     */
+    std::unordered_set<const ast::Expression *> not_constant_;
+
+    std::optional<Constant> fold_operand(ast::Expression &expression);
+
+    template <typename... Overloads, typename Function>
+    std::optional<Constant> fold_binary(ast::BinaryExpression &node, Function f);
+
+public:
+    explicit ConstantFolder(const Analyzer &analyzer);
+
+    /**
+     * Returns whether the given function, or operator, e.g. "operator+", is one that can be folded.
+     */
+    [[nodiscard]] static bool folds(const std::string &function_name);
+
+    /**
+     * Returns the constant value of an operator or function call expression,
+     * or an empty value if it cannot be folded.
+     * Literals and identifiers are not folded, as they are already single value nodes.
+     */
+    [[nodiscard]] values::Value fold(ast::Expression &expression);
+
+    std::optional<Constant> visit_node(ast::Node &node) override;
+    std::optional<Constant> visit_boolean_literal(ast::BooleanLiteral &node) override;
+    std::optional<Constant> visit_integer_literal(ast::IntegerLiteral &node) override;
+    std::optional<Constant> visit_float_literal(ast::FloatLiteral &node) override;
+    std::optional<Constant> visit_identifier(ast::Identifier &node) override;
+    std::optional<Constant> visit_function_call(ast::FunctionCall &node) override;
+    std::optional<Constant> visit_unary_minus_expression(ast::UnaryMinusExpression &node) override;
+    std::optional<Constant> visit_bitwise_not_expression(ast::BitwiseNotExpression &node) override;
+    std::optional<Constant> visit_logical_not_expression(ast::LogicalNotExpression &node) override;
+    std::optional<Constant> visit_power_expression(ast::PowerExpression &node) override;
+    std::optional<Constant> visit_product_expression(ast::ProductExpression &node) override;
+    std::optional<Constant> visit_division_expression(ast::DivisionExpression &node) override;
+    std::optional<Constant> visit_modulo_expression(ast::ModuloExpression &node) override;
+    std::optional<Constant> visit_addition_expression(ast::AdditionExpression &node) override;
+    std::optional<Constant> visit_subtraction_expression(ast::SubtractionExpression &node) override;
+    std::optional<Constant> visit_shift_left_expression(ast::ShiftLeftExpression &node) override;
+    std::optional<Constant> visit_shift_right_expression(ast::ShiftRightExpression &node) override;
+    std::optional<Constant> visit_cmp_gt_expression(ast::CmpGtExpression &node) override;
+    std::optional<Constant> visit_cmp_lt_expression(ast::CmpLtExpression &node) override;
+    std::optional<Constant> visit_cmp_ge_expression(ast::CmpGeExpression &node) override;
+    std::optional<Constant> visit_cmp_le_expression(ast::CmpLeExpression &node) override;
+    std::optional<Constant> visit_cmp_eq_expression(ast::CmpEqExpression &node) override;
+    std::optional<Constant> visit_cmp_ne_expression(ast::CmpNeExpression &node) override;
+    std::optional<Constant> visit_bitwise_and_expression(ast::BitwiseAndExpression &node) override;
+    std::optional<Constant> visit_bitwise_xor_expression(ast::BitwiseXorExpression &node) override;
+    std::optional<Constant> visit_bitwise_or_expression(ast::BitwiseOrExpression &node) override;
+    std::optional<Constant> visit_logical_and_expression(ast::LogicalAndExpression &node) override;
+    std::optional<Constant> visit_logical_xor_expression(ast::LogicalXorExpression &node) override;
+    std::optional<Constant> visit_logical_or_expression(ast::LogicalOrExpression &node) override;
+    std::optional<Constant> visit_ternary_conditional_expression(ast::TernaryConditionalExpression &node) override;
+};
+
+}  // namespace cqasm::v3x::analyzer
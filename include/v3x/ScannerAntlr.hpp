@@ -3,15 +3,35 @@
 #include "v3x/BuildCustomAstVisitor.hpp"
 #include "v3x/cqasm-parse-result.hpp"
 
+#include <cstddef>  // size_t
 #include <memory>  // unique_ptr
 #include <string>
+#include <string_view>
 
-namespace antlr4 { class ANTLRInputStream; }
+namespace antlr4 { class CharStream; }
 namespace cqasm::v3x::parser { class CustomErrorListener; }
 
 
 namespace cqasm::v3x::parser {
 
+/**
+ * Prediction strategy of the ANTLR parser.
+ */
+enum class PredictionMode {
+    /**
+     * Parse with the faster SLL prediction and a bail-out error strategy first,
+     * and only parse again with full LL prediction if that fails.
+     * SLL prediction accepts a subset of the inputs accepted by full LL prediction,
+     * so the result, and the errors reported for incorrect programs, are the same as with full LL prediction.
+     */
+    sll_first,
+
+    /**
+     * Parse with full LL prediction only.
+     */
+    ll
+};
+
 struct ScannerAdaptor {
     virtual ~ScannerAdaptor();
 
@@ -21,16 +41,43 @@ struct ScannerAdaptor {
 class ScannerAntlr : public ScannerAdaptor {
     std::unique_ptr<BuildCustomAstVisitor> build_visitor_up_;
     std::unique_ptr<CustomErrorListener> error_listener_up_;
+    PredictionMode prediction_mode_;
 protected:
-    cqasm::v3x::parser::ParseResult parse_(antlr4::ANTLRInputStream &is);
+    cqasm::v3x::parser::ParseResult parse_(antlr4::CharStream &is);
+
+    /**
+     * Parses data without copying it, unless it contains non-ASCII characters.
+     */
+    cqasm::v3x::parser::ParseResult parse_view_(std::string_view data);
 
 public:
     ScannerAntlr(std::unique_ptr<BuildCustomAstVisitor> build_visitor_up,
-        std::unique_ptr<CustomErrorListener> error_listener_up);
+        std::unique_ptr<CustomErrorListener> error_listener_up,
+        PredictionMode prediction_mode = PredictionMode::sll_first);
 
     ~ScannerAntlr() override;
 
     cqasm::v3x::parser::ParseResult parse() override = 0;
+
+    /**
+     * Returns the number of states in the DFA cache of the parser.
+     * ANTLR caches the results of prediction in DFAs that are shared by all the parsers in the process,
+     * and only grow as inputs exercise new paths through the grammar.
+     */
+    static std::size_t dfa_cache_size();
+
+    /**
+     * Clears the DFA caches of the lexer and the parser.
+     * Waits for the parses in progress to finish.
+     */
+    static void clear_dfa_cache();
+
+    /**
+     * Bounds the DFA cache of the parser to max_states states, 0 meaning no bound.
+     * The bound is checked before each parse, if no other parse is in progress at that moment,
+     * and the DFA caches are cleared when it is exceeded.
+     */
+    static void set_dfa_cache_limit(std::size_t max_states);
 };
 
 class ScannerAntlrFile : public ScannerAntlr {
@@ -38,7 +85,8 @@ class ScannerAntlrFile : public ScannerAntlr {
 public:
     ScannerAntlrFile(std::unique_ptr<BuildCustomAstVisitor> build_visitor_up,
         std::unique_ptr<CustomErrorListener> error_listener_up,
-        const std::string &file_path);
+        const std::string &file_path,
+        PredictionMode prediction_mode = PredictionMode::sll_first);
 
     ~ScannerAntlrFile() override;
 
@@ -50,11 +98,29 @@ class ScannerAntlrString : public ScannerAntlr {
 public:
     ScannerAntlrString(std::unique_ptr<BuildCustomAstVisitor> build_visitor_up,
         std::unique_ptr<CustomErrorListener> error_listener_up,
-        const std::string &data);
+        const std::string &data,
+        PredictionMode prediction_mode = PredictionMode::sll_first);
 
     ~ScannerAntlrString() override;
 
     cqasm::v3x::parser::ParseResult parse() override;
 };
 
+/**
+ * Scanner over a caller-owned buffer, e.g. a memory-mapped file.
+ * The data is not copied, so it must outlive the call to parse().
+ */
+class ScannerAntlrView : public ScannerAntlr {
+    std::string_view data_;
+public:
+    ScannerAntlrView(std::unique_ptr<BuildCustomAstVisitor> build_visitor_up,
+        std::unique_ptr<CustomErrorListener> error_listener_up,
+        std::string_view data,
+        PredictionMode prediction_mode = PredictionMode::sll_first);
+
+    ~ScannerAntlrView() override;
+
+    cqasm::v3x::parser::ParseResult parse() override;
+};
+
 }  // namespace cqasm::v3x::parser
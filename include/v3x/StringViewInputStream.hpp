@@ -0,0 +1,45 @@
+#pragma once
+
+#include <antlr4-runtime.h>
+#include <cstddef>  // size_t
+#include <string>
+#include <string_view>
+
+
+namespace cqasm::v3x::parser {
+
+/**
+ * ANTLR character stream over a caller-owned ASCII buffer.
+ *
+ * Unlike antlr4::ANTLRInputStream, which decodes its whole input into a UTF-32 copy,
+ * this stream hands out the bytes of the buffer as they are.
+ * That is only correct for 7-bit ASCII data, see is_ascii.
+ * The buffer is not copied, so it must outlive the stream and any lexer reading from it.
+ */
+class StringViewInputStream : public antlr4::CharStream {
+    std::string_view data_;
+    std::string name_;
+    std::size_t position_{ 0 };
+
+public:
+    explicit StringViewInputStream(std::string_view data, std::string name = {});
+
+    /**
+     * Returns whether every character in data is 7-bit ASCII,
+     * i.e. whether a StringViewInputStream can be used to scan it.
+     */
+    [[nodiscard]] static bool is_ascii(std::string_view data);
+
+    void consume() override;
+    size_t LA(ssize_t i) override;
+    ssize_t mark() override;
+    void release(ssize_t marker) override;
+    size_t index() override;
+    void seek(size_t index) override;
+    size_t size() override;
+    [[nodiscard]] std::string getSourceName() const override;
+    std::string getText(const antlr4::misc::Interval &interval) override;
+    [[nodiscard]] std::string toString() const override;
+};
+
+}  // namespace cqasm::v3x::parser
@@ -3,9 +3,11 @@
 #include "cqasm-ast.hpp"
 #include "cqasm-error.hpp"
 #include "cqasm-semantic.hpp"
+#include "cqasm-tree.hpp"
 
 #include <stdexcept>  // runtime_error
 #include <iosfwd>  // ostream
+#include <memory>  // shared_ptr
 #include <string>
 #include <vector>
 
@@ -59,6 +61,25 @@ public:
      */
     error::AnalysisErrors errors;
 
+    /**
+     * Arena the nodes of the tree are allocated from, if the analyzer had use_arena set, or null otherwise.
+     * The memory of the whole tree is released in one go, when the last result sharing the arena is destroyed,
+     * so the tree, including the root returned by unwrap(), must not outlive the results holding the arena.
+     * It is declared last, so that assigning a result releases the previous tree before its arena.
+     */
+    std::shared_ptr<tree::Arena> arena;
+
+    AnalysisResult() = default;
+    AnalysisResult(const AnalysisResult &other) = default;
+    AnalysisResult(AnalysisResult &&other) noexcept = default;
+    AnalysisResult &operator=(const AnalysisResult &other) = default;
+    AnalysisResult &operator=(AnalysisResult &&other) noexcept = default;
+
+    /**
+     * Releases the tree before the arena it is allocated from, if any.
+     */
+    ~AnalysisResult();
+
     /**
      * "Unwraps" the result (as you would in Rust) to get the program node or an exception.
      * The exception is always an AnalysisFailed, deriving from std::runtime_error.
@@ -0,0 +1,131 @@
+/** \file
+ * This file contains the \ref cqasm::v3x::analyzer::AnalyzerConfig "AnalyzerConfig" class,
+ * i.e. the part of a semantic analyzer that does not change from one analysis to the next.
+ */
+
+#pragma once
+
+#include "v3x/cqasm-instruction.hpp"
+#include "v3x/cqasm-primitives.hpp"
+#include "v3x/cqasm-resolver.hpp"
+#include "v3x/cqasm-types.hpp"
+#include "v3x/cqasm-values.hpp"
+
+#include <optional>
+#include <string>
+
+
+namespace cqasm::v3x::analyzer {
+
+/**
+ * Configuration of a semantic analyzer:
+ * the maximum supported cQASM version, the initial mappings, the function implementations, and the instruction set.
+ *
+ * An AnalyzerConfig is built once, using the `register_*()` methods, and then shared,
+ * through a `std::shared_ptr<const AnalyzerConfig>`, by any number of \ref Analyzer objects.
+ * Name and overload resolution never modify a configuration, other than memoizing overload resolutions
+ * under an internal lock, so a const AnalyzerConfig can be used by concurrent analyses without any external locking.
+ *
+ * As long as the default functions are registered, and none of them is overridden,
+ * constant expressions are folded directly on primitive values, see \ref ConstantFolder.
+ */
+class AnalyzerConfig {
+    /**
+     * Whether the default functions have been registered.
+     */
+    bool has_default_function_impls_ = false;
+
+    /**
+     * Whether a function implementation has been registered for one of the default functions or operators.
+     */
+    bool overrides_default_function_impls_ = false;
+
+    /**
+     * The list of function implementations.
+     * That is, functions for which we have a C++ implementation.
+     * It is only modified by register_default_functions() and register_function_impl(),
+     * which keep track of whether the default functions can still be folded by a \ref ConstantFolder.
+     */
+    resolver::FunctionImplTable function_impl_table_;
+
+public:
+    /**
+     * The maximum cQASM version that this configuration supports.
+     */
+    primitives::Version api_version;
+
+    /**
+     * The initial mappings, e.g. pi or true.
+     */
+    resolver::VariableTable variable_table;
+
+    /**
+     * The supported instructions.
+     * Instructions have a case-sensitively matched name,
+     * and a signature for the types of parameters they expect.
+     */
+    resolver::InstructionTable instruction_table;
+
+    /**
+     * Creates a new, empty, analyzer configuration.
+     */
+    explicit AnalyzerConfig(const primitives::Version &api_version = "3.0");
+
+    /**
+     * Registers mappings for pi, eu (aka e, 2.718...), tau and im (imaginary unit).
+     */
+    void register_default_mappings();
+
+    /**
+     * Registers a number of default functions, such as the operator functions, and the usual trigonometric functions.
+     */
+    void register_default_functions();
+
+    /**
+     * Registers an initial mapping.
+     */
+    void register_variable(const std::string &name, const values::Value &value);
+
+    /**
+     * Registers a function implementation, usable within expressions.
+     */
+    void register_function_impl(
+        const std::string &name,
+        const types::Types &param_types,
+        const resolver::FunctionImpl &impl);
+
+    /**
+     * Convenience method for registering a function implementation.
+     * The param_types are specified as a string,
+     * converted to types::Types for the other overload using types::from_spec.
+     */
+    void register_function_impl(
+        const std::string &name,
+        const std::string &param_types,
+        const resolver::FunctionImpl &impl);
+
+    /**
+     * Registers an instruction type.
+     */
+    void register_instruction(const instruction::Instruction &instruction);
+
+    /**
+     * Convenience method for registering an instruction type.
+     * The arguments are passed straight to instruction::Instruction's constructor.
+     */
+    void register_instruction(const std::string &name, const std::optional<std::string> &param_types);
+
+    /**
+     * Returns the list of function implementations.
+     * Function implementations are registered with register_default_functions() and register_function_impl().
+     */
+    [[nodiscard]] const resolver::FunctionImplTable &function_impl_table() const;
+
+    /**
+     * Returns whether constant expressions can be folded by a \ref ConstantFolder,
+     * i.e. whether the default functions are registered, and none of them has been overridden.
+     */
+    [[nodiscard]] bool folds_constants() const;
+};
+
+} // namespace cqasm::v3x::analyzer
@@ -10,16 +10,22 @@
 
 #include "cqasm-analysis-result.hpp"
 #include "cqasm-analyzer.hpp"
+#include "cqasm-analyzer-config.hpp"
 #include "cqasm-ast.hpp"
 #include "cqasm-parse-helper.hpp"
 #include "cqasm-resolver.hpp"
 #include "cqasm-semantic.hpp"
 #include "v3x/cqasm-scope.hpp"
 
+#include <cstddef>  // size_t
 #include <functional>
 #include <list>
+#include <memory>  // shared_ptr
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <vector>
 
 
 /**
@@ -41,8 +47,14 @@ namespace cqasm::v3x::analyzer {
  *  - Use one or more of the `analyze*()` methods to analyze cQASM files
  *    or string representations thereof.
  *
- * Note that the only state maintained by the Analyzer object is its configuration,
- * and the `analyze*()` functions never change this state (hence they are const).
+ * The configuration of an Analyzer (API version, initial mappings, function implementations, and instructions)
+ * is kept in an \ref AnalyzerConfig, separately from the scope stack used while analyzing a program.
+ * The scope stack is reset at the beginning of every analysis,
+ * so the same Analyzer object can be used to analyze any number of programs, one after the other.
+ *
+ * To analyze programs concurrently, build the configuration once,
+ * get it with config(), and construct a (cheap) Analyzer per analysis from it:
+ * all these analyzers share the same immutable configuration, without copying or locking it.
  */
 class Analyzer {
     friend class AnalyzeTreeGenAstVisitor;
@@ -53,9 +65,42 @@ public:
      */
     primitives::Version api_version;
 
+    /**
+     * Whether the analyze() methods taking closures, and thus analyze_file(), analyze_string() and analyze_batch(),
+     * allocate the nodes of the trees they build from a new tree::Arena per program.
+     * The returned AnalysisResult owns the arena, and the memory of its tree is released in one go with it.
+     * This makes building and destroying large trees cheaper,
+     * but the tree must then not outlive the result it was returned in.
+     */
+    bool use_arena = false;
+
 protected:
+    /**
+     * The configuration of this analyzer, if only this analyzer references it, so that it can be modified in place.
+     * It is then the same object as config_. It is null if config_ may be shared with anyone else,
+     * i.e. if it was given to the constructor, returned by config(), or the analyzer was copied.
+     */
+    mutable std::shared_ptr<AnalyzerConfig> owned_config_;
+
+    /**
+     * The configuration of this analyzer.
+     * It may be shared with other analyzers, in which case it is copied before being modified (copy-on-write).
+     */
+    std::shared_ptr<const AnalyzerConfig> config_;
+
     std::list<Scope> scope_stack_;
 
+    /**
+     * Returns the configuration, so that it can be modified.
+     * The configuration is copied first if it may be shared with anyone else.
+     */
+    [[nodiscard]] AnalyzerConfig &mutable_config();
+
+    /**
+     * Resets the scope stack to a single, empty, global scope.
+     */
+    void reset_scope_stack();
+
     [[nodiscard]] Scope &global_scope();
     [[nodiscard]] Scope &current_scope();
     [[nodiscard]] tree::One<semantic::Block> current_block();
@@ -73,11 +118,34 @@ public:
      */
     explicit Analyzer(const primitives::Version &api_version = "3.0");
 
+    /**
+     * Creates a new semantic analyzer that uses the given configuration.
+     * The configuration is shared, not copied.
+     */
+    explicit Analyzer(std::shared_ptr<const AnalyzerConfig> config);
+
+    /**
+     * Copies a semantic analyzer.
+     * The copy shares the configuration of the original, and either of them copies it before modifying it.
+     */
+    Analyzer(const Analyzer &other);
+    Analyzer(Analyzer &&other) noexcept = default;
+    Analyzer &operator=(const Analyzer &other);
+    Analyzer &operator=(Analyzer &&other) noexcept = default;
+
     /**
      * Destroys a semantic analyzer.
      */
      virtual ~Analyzer() = default;
 
+    /**
+     * Returns the configuration of this analyzer, so that it can be shared with other analyzers.
+     * Later calls to the `register_*()` methods of this analyzer will not modify the returned configuration.
+     * This is not thread-safe with respect to other calls on this analyzer,
+     * so get the configuration once, and share it from there.
+     */
+    [[nodiscard]] std::shared_ptr<const AnalyzerConfig> config() const;
+
     /**
      * Registers mappings for pi, eu (aka e, 2.718...), tau and im (imaginary unit).
      */
@@ -90,6 +158,7 @@ public:
 
     /**
      * Analyzes the given program AST node.
+     * Every call starts from an empty global scope.
      */
     [[nodiscard]] virtual AnalysisResult analyze(ast::Program &program);
 
@@ -110,6 +179,7 @@ public:
 
     /**
      * Parses and analyzes the given file.
+     * The file is read only once, and its contents shared by the version check and the parser.
      */
     [[nodiscard]] virtual AnalysisResult analyze_file(const std::string &file_name);
 
@@ -120,6 +190,17 @@ public:
     [[nodiscard]] virtual AnalysisResult analyze_string(
         const std::string &data, const std::optional<std::string> &file_name);
 
+    /**
+     * Parses and analyzes each of the given programs, concurrently, using up to thread_count threads.
+     * A thread_count of 0 means as many threads as the hardware supports.
+     * Every thread analyzes programs one after the other with its own Analyzer,
+     * sharing this analyzer's configuration.
+     * Overrides of the virtual methods of this class are thus not used.
+     * Returns the results in the same order as the programs.
+     */
+    [[nodiscard]] std::vector<AnalysisResult> analyze_batch(
+        std::span<const std::string_view> programs, std::size_t thread_count = 0) const;
+
     /**
      * Pushes a new empty scope to the top of the scope stack.
      */
@@ -136,7 +217,7 @@ public:
     virtual void add_statement_to_current_scope(const tree::One<semantic::Statement> &statement);
 
     /**
-     * Adds a variable to the current scope.
+     * Adds a variable to the current scope, and registers a reference to it under its name.
      */
     virtual void add_variable_to_current_scope(const tree::One<semantic::Variable> &variable);
 
@@ -148,11 +229,13 @@ public:
     /**
      * Resolves a variable.
      * Throws NameResolutionFailure if no variable by the given name exists.
+     * The value is shared with the variable table, so it must be copied before being modified or added to a tree.
      */
     [[nodiscard]] virtual values::Value resolve_variable(const std::string &name) const;
 
     /**
-     * Registers a variable.
+     * Registers an initial mapping, visible to all the programs analyzed afterwards.
+     * The variables declared by a program are registered by add_variable_to_current_scope instead.
      */
     virtual void register_variable(const std::string &name, const values::Value &value);
 
@@ -1,11 +1,17 @@
 #pragma once
 
+#include "cqasm-error.hpp"
 #include "v3x/cqasm-primitives.hpp"
 #include "v3x/cqasm-resolver.hpp"
 
+#include <algorithm>  // transform
 #include <cmath>
+#include <cstdint>  // uint8_t
+#include <fmt/format.h>
 #include <functional>
 #include <numeric>
+#include <type_traits>  // conditional_t, is_same_v
+#include <vector>
 
 namespace primitives = cqasm::v3x::primitives;
 
@@ -73,6 +79,117 @@ struct tf_cp : public f_cp<ParamType, ParamType, F> {
     }
 };
 
+/**
+ * Constant type of the elements of a constant array type
+ */
+template <typename ConstTypeArray>
+struct array_element;
+template <>
+struct array_element<values::ConstBoolArray> { using type = values::ConstBool; };
+template <>
+struct array_element<values::ConstIntArray> { using type = values::ConstInt; };
+template <>
+struct array_element<values::ConstFloatArray> { using type = values::ConstFloat; };
+
+template <typename ConstTypeArray>
+using array_element_t = typename array_element<ConstTypeArray>::type;
+
+/**
+ * Type of the contiguous vectors of primitive values of the elements of a constant array type
+ * Booleans are stored as std::uint8_t, as std::vector<bool> is bit-packed, and its elements can't be vectorized over
+ */
+template <typename ConstTypeArray>
+using array_storage_t = std::conditional_t<
+    std::is_same_v<decltype(array_element_t<ConstTypeArray>::value), primitives::Bool>,
+    std::vector<std::uint8_t>,
+    std::vector<decltype(array_element_t<ConstTypeArray>::value)>>;
+
+/**
+ * Returns the elements of a constant array, or the single element of a constant scalar,
+ * as a contiguous vector of primitive values
+ */
+template <typename ConstTypeArray>
+auto array_operand(const values::Value &value) {
+    using ConstType = array_element_t<ConstTypeArray>;
+    array_storage_t<ConstTypeArray> ret{};
+    if (const auto array = value.as<ConstTypeArray>(); !array.empty()) {
+        const auto &items = array->value.get_vec();
+        ret.resize(items.size());
+        std::transform(items.begin(), items.end(), ret.begin(), [](const auto &item) { return item->value; });
+    } else {
+        ret.push_back(value.as<ConstType>()->value);
+    }
+    return ret;
+}
+
+/**
+ * Builds a constant array from a contiguous vector of primitive values
+ * The elements are stored packed, in a single allocation, see tree::make_many
+ */
+template <typename ConstTypeArray, typename T>
+values::Value make_array(const std::vector<T> &elements) {
+    auto ret = tree::make<ConstTypeArray>();
+    ret->value = tree::make_many<array_element_t<ConstTypeArray>>(elements.size());
+    auto element = elements.begin();
+    for (auto &item : ret->value) {
+        item->value = *element++;
+    }
+    return ret;
+}
+
+/**
+ * Unary element-wise function with constant array parameter
+ * F is applied in a single loop over contiguous primitive values, which the compiler can vectorize
+ */
+template <typename ReturnTypeArray, typename ParamTypeArray, auto F>
+struct uf_cp_array : public f_cp<ReturnTypeArray, ParamTypeArray, F> {
+    values::Value operator()(const values::Values &vs) const {
+        values::check_const(vs);
+        const auto arg = array_operand<ParamTypeArray>(vs[0]);
+        array_storage_t<ReturnTypeArray> ret(arg.size());
+        for (std::size_t i = 0; i < arg.size(); ++i) {
+            ret[i] = F(arg[i]);
+        }
+        return make_array<ReturnTypeArray>(ret);
+    }
+};
+
+/**
+ * Binary element-wise function with constant parameters
+ * The parameters are either two arrays of the same size, or an array and a scalar,
+ * in which case the scalar is combined with every element of the array
+ * F is applied in a single loop over contiguous primitive values, which the compiler can vectorize
+ */
+template <typename ReturnTypeArray, typename ParamTypeArray, auto F>
+struct bf_cp_array : public f_cp<ReturnTypeArray, ParamTypeArray, F> {
+    values::Value operator()(const values::Values &vs) const {
+        values::check_const(vs);
+        const auto a = array_operand<ParamTypeArray>(vs[0]);
+        const auto b = array_operand<ParamTypeArray>(vs[1]);
+        const auto a_is_scalar = vs[0].as<ParamTypeArray>().empty();
+        const auto b_is_scalar = vs[1].as<ParamTypeArray>().empty();
+        if (!a_is_scalar && !b_is_scalar && a.size() != b.size()) {
+            throw error::AnalysisError{
+                fmt::format("element-wise operation on arrays of different sizes ({} and {})", a.size(), b.size()) };
+        }
+        array_storage_t<ReturnTypeArray> ret(a_is_scalar ? b.size() : a.size());
+        if (a_is_scalar) {
+            for (std::size_t i = 0; i < ret.size(); ++i) {
+                ret[i] = F(a[0], b[i]);
+            }
+        } else if (b_is_scalar) {
+            for (std::size_t i = 0; i < ret.size(); ++i) {
+                ret[i] = F(a[i], b[0]);
+            }
+        } else {
+            for (std::size_t i = 0; i < ret.size(); ++i) {
+                ret[i] = F(a[i], b[i]);
+            }
+        }
+        return make_array<ReturnTypeArray>(ret);
+    }
+};
+
 constexpr auto op_neg_f = uf_cp<values::ConstFloat, values::ConstFloat, std::negate<double>{}>{};
 constexpr auto op_neg_i = uf_cp<values::ConstInt, values::ConstInt, std::negate{}>{};
 
@@ -166,6 +283,66 @@ constexpr auto abs = [](auto num) { return std::abs(num); };
 constexpr auto fn_abs_f = uf_cp<values::ConstFloat, values::ConstFloat, abs>{};
 constexpr auto fn_abs_i = uf_cp<values::ConstInt, values::ConstInt, abs>{};
 
+constexpr auto op_neg_Z = uf_cp_array<values::ConstFloatArray, values::ConstFloatArray, std::negate<double>{}>{};
+constexpr auto op_neg_Y = uf_cp_array<values::ConstIntArray, values::ConstIntArray, std::negate{}>{};
+
+constexpr auto op_add_Z = bf_cp_array<values::ConstFloatArray, values::ConstFloatArray, std::plus{}>{};
+constexpr auto op_add_Y = bf_cp_array<values::ConstIntArray, values::ConstIntArray, std::plus{}>{};
+constexpr auto op_sub_Z = bf_cp_array<values::ConstFloatArray, values::ConstFloatArray, std::minus{}>{};
+constexpr auto op_sub_Y = bf_cp_array<values::ConstIntArray, values::ConstIntArray, std::minus{}>{};
+
+constexpr auto op_mul_Z = bf_cp_array<values::ConstFloatArray, values::ConstFloatArray, std::multiplies{}>{};
+constexpr auto op_mul_Y = bf_cp_array<values::ConstIntArray, values::ConstIntArray, std::multiplies{}>{};
+constexpr auto op_div_Z = bf_cp_array<values::ConstFloatArray, values::ConstFloatArray, std::divides{}>{};
+constexpr auto op_div_Y = bf_cp_array<values::ConstIntArray, values::ConstIntArray, std::divides{}>{};
+constexpr auto op_mod_Y = bf_cp_array<values::ConstIntArray, values::ConstIntArray, std::modulus{}>{};
+
+constexpr auto op_pow_Z = bf_cp_array<values::ConstFloatArray, values::ConstFloatArray, pow>{};
+
+constexpr auto op_eq_Z = bf_cp_array<values::ConstBoolArray, values::ConstFloatArray, std::equal_to{}>{};
+constexpr auto op_ne_Z = bf_cp_array<values::ConstBoolArray, values::ConstFloatArray, std::not_equal_to{}>{};
+constexpr auto op_ge_Z = bf_cp_array<values::ConstBoolArray, values::ConstFloatArray, std::greater_equal{}>{};
+constexpr auto op_gt_Z = bf_cp_array<values::ConstBoolArray, values::ConstFloatArray, std::greater{}>{};
+constexpr auto op_le_Z = bf_cp_array<values::ConstBoolArray, values::ConstFloatArray, std::less_equal{}>{};
+constexpr auto op_lt_Z = bf_cp_array<values::ConstBoolArray, values::ConstFloatArray, std::less{}>{};
+
+constexpr auto op_eq_Y = bf_cp_array<values::ConstBoolArray, values::ConstIntArray, std::equal_to{}>{};
+constexpr auto op_ne_Y = bf_cp_array<values::ConstBoolArray, values::ConstIntArray, std::not_equal_to{}>{};
+constexpr auto op_ge_Y = bf_cp_array<values::ConstBoolArray, values::ConstIntArray, std::greater_equal{}>{};
+constexpr auto op_gt_Y = bf_cp_array<values::ConstBoolArray, values::ConstIntArray, std::greater{}>{};
+constexpr auto op_le_Y = bf_cp_array<values::ConstBoolArray, values::ConstIntArray, std::less_equal{}>{};
+constexpr auto op_lt_Y = bf_cp_array<values::ConstBoolArray, values::ConstIntArray, std::less{}>{};
+
+constexpr auto op_eq_X = bf_cp_array<values::ConstBoolArray, values::ConstBoolArray, std::equal_to{}>{};
+constexpr auto op_ne_X = bf_cp_array<values::ConstBoolArray, values::ConstBoolArray, std::not_equal_to{}>{};
+constexpr auto op_ge_X = bf_cp_array<values::ConstBoolArray, values::ConstBoolArray, std::greater_equal{}>{};
+constexpr auto op_gt_X = bf_cp_array<values::ConstBoolArray, values::ConstBoolArray, std::greater{}>{};
+constexpr auto op_le_X = bf_cp_array<values::ConstBoolArray, values::ConstBoolArray, std::less_equal{}>{};
+constexpr auto op_lt_X = bf_cp_array<values::ConstBoolArray, values::ConstBoolArray, std::less{}>{};
+
+constexpr auto fn_sqrt_Z = uf_cp_array<values::ConstFloatArray, values::ConstFloatArray, sqrt>{};
+constexpr auto fn_exp_Z = uf_cp_array<values::ConstFloatArray, values::ConstFloatArray, exp>{};
+constexpr auto fn_log_Z = uf_cp_array<values::ConstFloatArray, values::ConstFloatArray, log>{};
+constexpr auto fn_sin_Z = uf_cp_array<values::ConstFloatArray, values::ConstFloatArray, sin>{};
+constexpr auto fn_cos_Z = uf_cp_array<values::ConstFloatArray, values::ConstFloatArray, cos>{};
+constexpr auto fn_tan_Z = uf_cp_array<values::ConstFloatArray, values::ConstFloatArray, tan>{};
+constexpr auto fn_sinh_Z = uf_cp_array<values::ConstFloatArray, values::ConstFloatArray, sinh>{};
+constexpr auto fn_cosh_Z = uf_cp_array<values::ConstFloatArray, values::ConstFloatArray, cosh>{};
+constexpr auto fn_tanh_Z = uf_cp_array<values::ConstFloatArray, values::ConstFloatArray, tanh>{};
+constexpr auto fn_asin_Z = uf_cp_array<values::ConstFloatArray, values::ConstFloatArray, asin>{};
+constexpr auto fn_acos_Z = uf_cp_array<values::ConstFloatArray, values::ConstFloatArray, acos>{};
+constexpr auto fn_atan_Z = uf_cp_array<values::ConstFloatArray, values::ConstFloatArray, atan>{};
+constexpr auto fn_asinh_Z = uf_cp_array<values::ConstFloatArray, values::ConstFloatArray, asinh>{};
+constexpr auto fn_acosh_Z = uf_cp_array<values::ConstFloatArray, values::ConstFloatArray, acosh>{};
+constexpr auto fn_atanh_Z = uf_cp_array<values::ConstFloatArray, values::ConstFloatArray, atanh>{};
+constexpr auto fn_abs_Z = uf_cp_array<values::ConstFloatArray, values::ConstFloatArray, abs>{};
+constexpr auto fn_abs_Y = uf_cp_array<values::ConstIntArray, values::ConstIntArray, abs>{};
+
+/**
+ * Registers the element-wise overloads of the default functions, for constant arrays, into the given function table.
+ */
+void register_default_array_function_impls_into(resolver::FunctionImplTable &table);
+
 /**
  * Registers a bunch of functions for which we have a C++ implementation into the given function table.
  */
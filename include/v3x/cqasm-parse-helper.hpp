@@ -10,9 +10,11 @@
 #include "v3x/cqasm-parse-result.hpp"
 #include "v3x/ScannerAntlr.hpp"
 
+#include <cstddef>  // size_t
 #include <memory>  // unique_ptr
 #include <optional>
 #include <string>
+#include <string_view>
 
 
 namespace cqasm::v3x::parser {
@@ -23,13 +25,52 @@ using SourceLocation = annotations::SourceLocation;
  * Parse using the given file path.
  * Throws a ParseError if this fails.
  */
-ParseResult parse_file(const std::string &file_path, const std::optional<std::string> &file_name);
+ParseResult parse_file(const std::string &file_path, const std::optional<std::string> &file_name,
+    PredictionMode prediction_mode = PredictionMode::sll_first);
 
 /**
  * Parse the given string.
  * A file_name may be given in addition for use within error messages.
+ * The prediction_mode only affects parsing speed, see PredictionMode.
  */
-ParseResult parse_string(const std::string &data, const std::optional<std::string> &file_name);
+ParseResult parse_string(const std::string &data, const std::optional<std::string> &file_name,
+    PredictionMode prediction_mode = PredictionMode::sll_first);
+
+/**
+ * Same as parse_string, but scans a caller-owned buffer, e.g. a memory-mapped file, without copying it.
+ * The data only has to stay alive for the duration of the call.
+ */
+ParseResult parse_view(std::string_view data, const std::optional<std::string> &file_name,
+    PredictionMode prediction_mode = PredictionMode::sll_first);
+
+/**
+ * Fills the lexer and parser DFA caches by parsing a built-in program that exercises every rule of the grammar,
+ * once with each PredictionMode, so that the first parses are fast whichever mode they use.
+ * The DFA caches are shared by all the parsers in the process, and otherwise only fill in lazily,
+ * which makes the first parses in a process much slower than the following ones.
+ * Throws a runtime_error if the built-in program does not parse without errors,
+ * as it would then stop short of some of the rules.
+ */
+void warm_up();
+
+/**
+ * Returns the number of states in the DFA cache of the parser.
+ */
+std::size_t dfa_cache_size();
+
+/**
+ * Clears the DFA caches of the lexer and the parser.
+ * Waits for the parses in progress to finish.
+ */
+void clear_dfa_cache();
+
+/**
+ * Bounds the DFA cache of the parser to max_states states, 0 meaning no bound.
+ * Useful for long-running processes parsing very diverse inputs.
+ * The bound is checked before each parse, if no other parse is in progress at that moment,
+ * and the DFA caches are cleared when it is exceeded.
+ */
+void set_dfa_cache_limit(std::size_t max_states);
 
 
 /**
@@ -9,6 +9,9 @@
 // Don't include any libqasm headers!
 // We don't want SWIG to generate Python wrappers for the entire world.
 // Those headers are only included in the source file that provides the implementations.
+#include "cqasm-py-result.hpp"
+
+#include <cstddef>  // size_t
 #include <memory>
 #include <string>
 #include <vector>
@@ -21,6 +24,11 @@ namespace cqasm::v3x::analyzer {
 
 /**
  * Main class for parsing and analyzing cQASM files with the v3.x API.
+ *
+ * The parse and analyze methods can be called concurrently on the same object:
+ * every analysis uses its own analyzer, sharing the configuration of this one.
+ * They release the Python GIL while running.
+ * The register methods, however, must not be called while analyses are in progress.
  */
 class V3xAnalyzer {
     /**
@@ -58,11 +66,9 @@ public:
      * Only parses the given file.
      * The file must be in v3.x syntax.
      * No version check or conversion is performed.
-     * Returns a vector of strings, of which the first is reserved for the CBOR serialization of the v3.x AST.
-     * Any additional strings represent error messages.
-     * Notice that the AST and error messages won't be available at the same time.
+     * Returns a PyResult with either the CBOR serialization of the v3.x AST, or the error messages.
      */
-    static std::vector<std::string> parse_file(const std::string &file_name);
+    static PyResult parse_file(const std::string &file_name);
 
     /**
      * Parses a file containing a v3.x program.
@@ -80,7 +86,7 @@ public:
      * Same as parse_file(), but instead receives the file contents directly.
      * The file_name, if non-empty, is only used when reporting errors.
      */
-    static std::vector<std::string> parse_string(const std::string &data, const std::string &file_name = "");
+    static PyResult parse_string(const std::string &data, const std::string &file_name = "");
 
     /**
      * Parses a data string containing a v3.x program.
@@ -95,16 +101,32 @@ public:
      */
     static std::string parse_string_to_json(const std::string &data, const std::string &file_name = "");
 
+    /**
+     * Fills the parser caches, shared by all the analyzers in the process,
+     * for both the SLL first and the LL only prediction modes,
+     * so that the first parses are as fast as the following ones.
+     */
+    static void warm_up();
+
+    /**
+     * Clears the parser caches.
+     */
+    static void clear_dfa_cache();
+
+    /**
+     * Bounds the parser caches to max_states states, 0 meaning no bound.
+     * The caches are cleared when the bound is exceeded.
+     */
+    static void set_dfa_cache_limit(std::size_t max_states);
+
     /**
      * Parses and analyzes the given file.
      * If the file is written in a later file version,
      * this function may try to reduce it to the maximum v3.x API version support advertised
      * using this object's constructor.
-     * Returns a vector of strings, of which the first is reserved for the CBOR serialization of the v3.x semantic tree.
-     * Any additional strings represent error messages.
-     * Notice that the AST and error messages won't be available at the same time.
+     * Returns a PyResult with either the CBOR serialization of the v3.x semantic tree, or the error messages.
      */
-    std::vector<std::string> analyze_file(const std::string &file_name) const;
+    PyResult analyze_file(const std::string &file_name) const;
 
     /**
      * Parses and analyzes a file containing a v3.x program.
@@ -122,7 +144,7 @@ public:
      * Same as analyze_file(), but instead receives the file contents directly.
      * The file_name, if non-empty, is only used when reporting errors.
      */
-    std::vector<std::string> analyze_string(const std::string &data, const std::string &file_name = "") const;
+    PyResult analyze_string(const std::string &data, const std::string &file_name = "") const;
 
     /**
      * Parses and analyzes a data string containing a v3.x program.
@@ -136,4 +158,12 @@ public:
      * severity is hardcoded to 1 at the moment (value corresponding to an Error level).
      */
     std::string analyze_string_to_json(const std::string &data, const std::string &file_name = "") const;
+
+    /**
+     * Same as analyze_string(), but for a list of programs, analyzed concurrently using up to thread_count threads.
+     * A thread_count of 0 means as many threads as the hardware supports.
+     * Returns one PyResult per program, in the same order as the programs.
+     */
+    std::vector<PyResult> analyze_batch(
+        const std::vector<std::string> &data, std::size_t thread_count = 0) const;
 };
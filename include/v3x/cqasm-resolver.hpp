@@ -86,9 +86,16 @@ public:
      */
     void add(const std::string &name, const values::Value &value);
 
+    /**
+     * Returns the value of a variable, or nullptr if no variable by the given name exists.
+     * The value is shared with this table, so it must not be modified nor added to a tree.
+     */
+    [[nodiscard]] const values::Value *find(const std::string &name) const;
+
     /**
      * Resolves a variable.
      * Throws NameResolutionFailure if no variable by the given name exists.
+     * The value is shared with this table, so it must be copied before being modified or added to a tree.
      */
     values::Value resolve(const std::string &name) const;
 };
@@ -9,6 +9,8 @@ namespace cqasm::v3x::analyzer {
 
 /**
  * Scope information.
+ * A scope only holds what is declared while analyzing a program.
+ * Initial mappings, function implementations, and instructions live in the AnalyzerConfig.
  */
 struct Scope {
     /**
@@ -16,25 +18,12 @@ struct Scope {
      */
     resolver::VariableTable variable_table;
 
-    /**
-     * The list of function implementations.
-     * That is, functions for which we have a C++ implementation.
-     */
-    resolver::FunctionImplTable function_impl_table;
-
     /**
      * The list of functions, other than function implementations.
      * That is, functions defined in the cQASM file.
      */
     resolver::FunctionTable function_table;
 
-    /**
-     * The instructions visible within this scope.
-     * Instructions have a case-sensitively matched name,
-     * and a signature for the types of parameters they expect.
-     */
-    resolver::InstructionTable instruction_table;
-
     /**
      * The block associated with this scope.
      */
@@ -57,13 +46,11 @@ struct Scope {
     Scope& operator=(Scope &&other) noexcept = default;
 
     /**
-     * Creates a scope from a table of variables, functions, and instructions.
+     * Creates a scope from a table of variables and functions.
      */
     Scope(
         resolver::VariableTable variable_table,
-        resolver::FunctionImplTable function_impl_table,
         resolver::FunctionTable function_table,
-        resolver::InstructionTable instruction_table,
         tree::One<semantic::Block> block);
 };
 
@@ -9,6 +9,7 @@
 
 #include <fmt/format.h>
 #include <fmt/ostream.h>
+#include <memory>  // make_shared
 
 
 /**
@@ -39,6 +40,20 @@ using Type = tree::One<TypeBase>;
  */
 using Types = tree::Any<TypeBase>;
 
+/**
+ * Returns the interned instance of type T, e.g. types::Int, with its default size.
+ *
+ * Interned types are shared by all the callers, so they must never be modified nor added to a tree.
+ * They are meant for type queries, such as `type_check(type, interned<Int>())`,
+ * which would otherwise allocate a new type node on every call.
+ */
+template <typename T>
+const Type &interned() {
+    // Not allocated with tree::make, which could put it in the arena of the analysis that happens to come first
+    static const Type type = tree::One<T>(std::make_shared<T>());
+    return type;
+}
+
 /**
  * Constructs a set of types from a shorthand string representation.
  * In it, each character represents one type. The supported characters are as follows:
@@ -7,12 +7,18 @@
 #pragma once
 
 #include "cqasm-ast.hpp"
+#include "cqasm-overload.hpp"
 #include "cqasm-types.hpp"
 #include "v3x/cqasm-values-gen.hpp"
 
-#include <algorithm>  // all_of, for_each
+#include <algorithm>  // all_of, transform
+#include <cstdint>  // uintptr_t
 #include <fmt/format.h>
 #include <fmt/ostream.h>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
 
 
 /**
@@ -31,6 +37,42 @@ using Value = tree::One<ValueBase>;
  */
 using Values = tree::Any<ValueBase>;
 
+/**
+ * Sets the elements of a constant array to copies of the given constant values.
+ * The elements are stored packed, in a single allocation, see tree::make_many.
+ * Pre condition: all the values are of the element type of the array.
+ */
+template <typename ConstType, typename Range>
+void assign_packed(tree::Many<ConstType> &elements, const Range &values) {
+    elements = tree::make_many<ConstType>(values.size());
+    auto value = values.begin();
+    for (auto &element : elements) {
+        *element = *value->template as<ConstType>();
+        ++value;
+    }
+}
+
+/**
+ * Returns a span over the elements of a constant array, if they are stored packed, in a single allocation,
+ * as assign_packed and tree::make_many do for the arrays built by the analyzer and the constant functions.
+ * Returns std::nullopt otherwise, e.g. if the elements were added to the array one at a time.
+ * The span is only valid as long as the elements of the array are not changed.
+ */
+template <typename ConstType>
+std::optional<std::span<const ConstType>> packed_span(const tree::Many<ConstType> &elements) {
+    if (elements.empty()) {
+        return std::span<const ConstType>{};
+    }
+    const auto *first = &*elements.at(0);
+    const auto first_address = reinterpret_cast<std::uintptr_t>(first);
+    for (std::size_t i = 1; i < elements.size(); ++i) {
+        if (reinterpret_cast<std::uintptr_t>(&*elements.at(i)) != first_address + i * sizeof(ConstType)) {
+            return std::nullopt;
+        }
+    }
+    return std::span<const ConstType>{ first, elements.size() };
+}
+
 /**
  * Promotes a value of array of Type to a value of array of PromotedType.
  * For example, given an array of bool, and a promoted type of float, returns an array of float.
@@ -39,11 +81,13 @@ using Values = tree::Any<ValueBase>;
 template <typename ConstTypeArray, typename ConstPromotedTypeArray, typename PromotedType>
 Value promote_array_value_to_array_type(const ConstTypeArray *array_value) {
     const auto &array_value_items = array_value->value.get_vec();
-    auto promoted_array_value = cqasm::tree::make<ConstPromotedTypeArray>();
-    std::for_each(array_value_items.begin(), array_value_items.end(),
-        [&promoted_array_value](const auto &item) {
-            promoted_array_value->value.add(promote(item, tree::make<PromotedType>()));
+    std::vector<Value> promoted_items(array_value_items.size());
+    std::transform(array_value_items.begin(), array_value_items.end(), promoted_items.begin(),
+        [](const auto &item) {
+            return promote(item, types::interned<PromotedType>());
     });
+    auto promoted_array_value = cqasm::tree::make<ConstPromotedTypeArray>();
+    assign_packed(promoted_array_value->value, promoted_items);
     return promoted_array_value;
 }
 
@@ -61,6 +105,13 @@ Value promote(const Value &value, const types::Type &type);
  */
 bool check_promote(const types::Type &from_type, const types::Type &to_type);
 
+/**
+ * Returns a key identifying the given value as far as promotion is concerned:
+ * values with the same key can be promoted to exactly the same types.
+ * Used to memoize overload resolutions.
+ */
+cqasm::overload::PromotionKey promotion_key(const Value &value);
+
 /**
  * Returns the element type of the given type.
  * Throws an error if the given type is not of array type.
@@ -82,6 +133,17 @@ types::Types types_of(const Values &values);
  */
 primitives::Int size_of(const Value &value);
 
+/**
+ * Returns the number of indices in the given index ranges.
+ */
+primitives::Int size_of(const tree::Many<IndexRange> &indices);
+
+/**
+ * Returns the individual indices in the given index ranges, in order.
+ * Index ranges are only expanded on demand, by the consumers that need every single index.
+ */
+std::vector<primitives::Int> expand_indices(const tree::Many<IndexRange> &indices);
+
 /**
  * Throws an AnalysisError if the given value is not a constant,
  * i.e. if it doesn't have a known value at this time.
@@ -9,6 +9,7 @@
 #include "v3x/cqasm-analyzer.hpp"
 #include "v3x/cqasm-semantic.hpp"
 
+#include <memory>  // shared_ptr
 #include <optional>
 
 
@@ -38,8 +39,18 @@ tree::One<cqasm::v3x::semantic::Program> analyze_string(
     const std::string &api_version = "3.0"
 );
 
+/**
+ * Returns an analyzer configuration with the defaults for cQASM 3.0 already loaded into it.
+ * The configuration for the default API version is built only once, the first time it is requested,
+ * and then shared by all the callers.
+ */
+std::shared_ptr<const analyzer::AnalyzerConfig> default_analyzer_config(
+    const std::string &api_version = "3.0"
+);
+
 /**
  * Constructs an Analyzer object with the defaults for cQASM 3.0 already loaded into it.
+ * The default configuration is shared, not copied, so this is cheap.
  */
 analyzer::Analyzer default_analyzer(
     const std::string &api_version = "3.0"
@@ -1,5 +1,5 @@
 /* libQasm_swig.i */
-%module libQasm
+%module(threads="1") libQasm
 
 %begin %{
 #ifdef _MSC_VER
@@ -8,6 +8,7 @@
 %}
 
 %{
+#include "cqasm-py-result.hpp"
 #include "v10/qasm_ast.hpp"
 #include "v10/libQasm.hpp"
 #include "v1x/cqasm-py.hpp"
@@ -47,6 +48,41 @@ namespace std {
     }
 }
 
+// Only the parse and analyze entry points release the GIL
+// They do not touch any Python object, and can be called concurrently on the same analyzer
+%nothread;
+%thread V1xAnalyzer::parse_file;
+%thread V1xAnalyzer::parse_file_to_json;
+%thread V1xAnalyzer::parse_string;
+%thread V1xAnalyzer::parse_string_to_json;
+%thread V1xAnalyzer::analyze_file;
+%thread V1xAnalyzer::analyze_file_to_json;
+%thread V1xAnalyzer::analyze_string;
+%thread V1xAnalyzer::analyze_string_to_json;
+%thread V3xAnalyzer::parse_file;
+%thread V3xAnalyzer::parse_file_to_json;
+%thread V3xAnalyzer::parse_string;
+%thread V3xAnalyzer::parse_string_to_json;
+%thread V3xAnalyzer::analyze_file;
+%thread V3xAnalyzer::analyze_file_to_json;
+%thread V3xAnalyzer::analyze_string;
+%thread V3xAnalyzer::analyze_string_to_json;
+%thread V3xAnalyzer::analyze_batch;
+%thread V3xAnalyzer::warm_up;
+
+// The CBOR serialization of a tree is binary data, so it is returned as a bytes object instead of a str
+%ignore PyResult::tree;
+%extend PyResult {
+    PyObject *tree_bytes() const {
+        return PyBytes_FromStringAndSize($self->tree.data(), static_cast<Py_ssize_t>($self->tree.size()));
+    }
+}
+%include "cqasm-py-result.hpp"
+
+namespace std {
+    %template(pyresult_vector) vector<PyResult>;
+}
+
 %include "v10/qasm_ast.hpp"
 %include "v10/libQasm.hpp"
 %include "v1x/cqasm-py.hpp"
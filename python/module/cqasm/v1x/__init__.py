@@ -8,47 +8,34 @@ class Analyzer(libQasm.V1xAnalyzer):
     # Instead, they just invoke free functions that create a temporary instance of a parser
     # analyze_file and analyze_string are not static methods because they change the status of the analyzer
 
-    # parse_file, parse_string, analyze_file, and analyze_string return a vector of strings
-    # If the length of the vector is 1, the string is a serialization of the AST
-    # Otherwise, it is a list of errors
+    # parse_file, parse_string, analyze_file, and analyze_string return a result holding
+    # either the CBOR serialization of the AST, as a bytes object, or a list of errors
 
     @staticmethod
     def parse_file(*args):
         ret = libQasm.V1xAnalyzer.parse_file(*args)
-        if len(ret) == 1:
-            serialized_ast_str = str(ret[0])
-            serialized_ast_bytes = serialized_ast_str.encode(encoding='utf-8', errors="surrogateescape")
-            deserialized_ast = ast.Root.deserialize(serialized_ast_bytes)
-            return deserialized_ast
-        return [str(error) for error in ret[1:]]
+        if not ret.errors:
+            return ast.Root.deserialize(ret.tree_bytes())
+        return [str(error) for error in ret.errors]
 
     @staticmethod
     def parse_string(*args):
         ret = libQasm.V1xAnalyzer.parse_string(*args)
-        if len(ret) == 1:
-            serialized_ast_str = str(ret[0])
-            serialized_ast_bytes = serialized_ast_str.encode(encoding='utf-8', errors="surrogateescape")
-            deserialized_ast = ast.Root.deserialize(serialized_ast_bytes)
-            return deserialized_ast
-        return [str(error) for error in ret[1:]]
+        if not ret.errors:
+            return ast.Root.deserialize(ret.tree_bytes())
+        return [str(error) for error in ret.errors]
 
     def analyze_file(self, *args):
         ret = super().analyze_file(*args)
-        if len(ret) == 1:
-            serialized_ast_str = str(ret[0])
-            serialized_ast_bytes = serialized_ast_str.encode(encoding='utf-8', errors="surrogateescape")
-            deserialized_ast = semantic.Program.deserialize(serialized_ast_bytes)
-            return deserialized_ast
-        return [str(error) for error in ret[1:]]
+        if not ret.errors:
+            return semantic.Program.deserialize(ret.tree_bytes())
+        return [str(error) for error in ret.errors]
 
     def analyze_string(self, *args):
         ret = super().analyze_string(*args)
-        if len(ret) == 1:
-            serialized_ast_str = str(ret[0])
-            serialized_ast_bytes = serialized_ast_str.encode(encoding='utf-8', errors="surrogateescape")
-            deserialized_ast = semantic.Program.deserialize(serialized_ast_bytes)
-            return deserialized_ast
-        return [str(error) for error in ret[1:]]
+        if not ret.errors:
+            return semantic.Program.deserialize(ret.tree_bytes())
+        return [str(error) for error in ret.errors]
 
     @staticmethod
     def parse_file_to_json(*args):
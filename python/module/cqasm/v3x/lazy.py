@@ -0,0 +1,281 @@
+"""
+Lazy, read-only views over the CBOR serialization of a v3.x syntactic or semantic tree.
+
+Deserializing a tree, e.g. with semantic.Program.deserialize, builds a Python object for every node up front.
+The views in this module keep the serialized buffer instead, and a node only holds an offset into it.
+Fields are decoded from the buffer when they are accessed, so reading a few fields of a large program
+costs roughly as much as the C++ serialization itself.
+
+Node fields are accessed as attributes, like on the generated node classes:
+child nodes come back as Node views, lists of nodes as NodeList views, links as the Node they point to,
+and primitives as the same Python values the generated classes would hold.
+"""
+
+from collections.abc import Sequence
+import struct
+
+import cqasm.v3x.instruction as instruction
+import cqasm.v3x.primitives as primitives
+
+
+_BREAK = 0xff
+_NULL = 0xf6
+
+
+def _head(buf, pos):
+    """
+    Decodes the head of the CBOR data item at pos.
+    Returns its major type, its argument (None for indefinite lengths), and the position right after the head.
+    """
+    initial = buf[pos]
+    major = initial >> 5
+    info = initial & 0x1f
+    pos += 1
+    if info < 24:
+        return major, info, pos
+    if info == 31:
+        return major, None, pos
+    if info > 27:
+        raise ValueError('invalid CBOR data item at offset {}'.format(pos - 1))
+    size = 1 << (info - 24)
+    return major, int.from_bytes(buf[pos:pos + size], 'big'), pos + size
+
+
+def _skip(buf, pos):
+    """Returns the position right after the CBOR data item at pos, without decoding it."""
+    major, arg, pos = _head(buf, pos)
+    if major in (2, 3, 4, 5):
+        if arg is None:
+            while buf[pos] != _BREAK:
+                pos = _skip(buf, pos)
+            return pos + 1
+        if major in (2, 3):
+            return pos + arg
+        for _ in range(arg * 2 if major == 5 else arg):
+            pos = _skip(buf, pos)
+    elif major == 6:
+        return _skip(buf, pos)
+    return pos
+
+
+def _items(buf, pos):
+    """
+    Yields the positions of the elements of the CBOR array at pos,
+    or of the keys and values, alternately, of the CBOR map at pos.
+    """
+    major, arg, pos = _head(buf, pos)
+    if arg is None:
+        while buf[pos] != _BREAK:
+            yield pos
+            pos = _skip(buf, pos)
+    else:
+        for _ in range(arg * 2 if major == 5 else arg):
+            yield pos
+            pos = _skip(buf, pos)
+
+
+def _decode(buf, pos):
+    """Fully decodes the CBOR data item at pos."""
+    major, arg, start = _head(buf, pos)
+    if major == 0:
+        return arg
+    if major == 1:
+        return -1 - arg
+    if major in (2, 3):
+        if arg is None:
+            chunks = [_decode(buf, chunk) for chunk in _items(buf, pos)]
+            return b''.join(chunks) if major == 2 else ''.join(chunks)
+        data = bytes(buf[start:start + arg])
+        return data if major == 2 else data.decode('utf-8')
+    if major == 4:
+        return [_decode(buf, element) for element in _items(buf, pos)]
+    if major == 5:
+        it = _items(buf, pos)
+        return {_decode(buf, key): _decode(buf, value) for key, value in zip(it, it)}
+    if major == 6:
+        return _decode(buf, start)
+    info = buf[pos] & 0x1f
+    if info == 20:
+        return False
+    if info == 21:
+        return True
+    if info in (22, 23):
+        return None
+    if info in (25, 26, 27):
+        return struct.unpack({25: '>e', 26: '>f', 27: '>d'}[info], buf[pos + 1:start])[0]
+    raise ValueError('unsupported CBOR data item at offset {}'.format(pos))
+
+
+def _map_offsets(buf, pos):
+    """Returns a dict from the keys of the CBOR map at pos to the positions of their values."""
+    it = _items(buf, pos)
+    return {_decode(buf, key): value for key, value in zip(it, it)}
+
+
+def _primitive(val):
+    """Converts the decoded serialization of a primitive to its Python value, as the generated classes do."""
+    keys = set(val)
+    if keys == {'x'}:
+        x = val['x']
+        if isinstance(x, bytes):
+            typ = primitives.Str
+        elif isinstance(x, bool):
+            typ = primitives.Bool
+        elif isinstance(x, int):
+            typ = primitives.Int
+        elif isinstance(x, float):
+            typ = primitives.Real
+        else:
+            typ = primitives.Version
+    elif keys == {'r', 'i'}:
+        typ = primitives.Complex
+    elif keys == {'x', 'y', 'z'}:
+        typ = primitives.Axis
+    else:
+        typ = instruction.InstructionRef
+    return primitives.deserialize(typ, val)
+
+
+class Tree:
+    """
+    A serialized tree, which views are taken over.
+    modules lists the generated modules whose node classes Node.materialize may use, in lookup order.
+    """
+
+    def __init__(self, cbor, modules=()):
+        super().__init__()
+        self._buffer = memoryview(cbor)
+        self._modules = tuple(modules)
+        self._sequence_offsets = None
+
+    @property
+    def root(self):
+        """The view over the root node."""
+        return Node(self, 0)
+
+    def _value(self, pos):
+        """Returns the value of the field serialized at pos."""
+        buf = self._buffer
+        fields = _map_offsets(buf, pos)
+        if '@T' not in fields:
+            return _primitive(_decode(buf, pos))
+        edge = _decode(buf, fields['@T'])
+        if edge in ('?', '1'):
+            if '@t' not in fields or buf[fields['@t']] == _NULL:
+                return None
+            return Node(self, pos, fields)
+        if edge in ('*', '+'):
+            return NodeList(self, fields['@d'])
+        if edge in ('$', '@'):
+            if '@l' not in fields or buf[fields['@l']] == _NULL:
+                return None
+            return self._node(_decode(buf, fields['@l']))
+        raise ValueError('unknown edge type {!r} at offset {}'.format(edge, pos))
+
+    def _node(self, sequence_number):
+        """Returns the node a link points to. The node offsets are indexed on the first link that is followed."""
+        if self._sequence_offsets is None:
+            buf = self._buffer
+            self._sequence_offsets = {}
+            stack = [0]
+            while stack:
+                pos = stack.pop()
+                major = buf[pos] >> 5
+                if major == 4:
+                    stack.extend(_items(buf, pos))
+                elif major == 5:
+                    for key, value in _map_offsets(buf, pos).items():
+                        if key == '@i':
+                            self._sequence_offsets[_decode(buf, value)] = pos
+                        else:
+                            stack.append(value)
+        pos = self._sequence_offsets.get(sequence_number)
+        if pos is None:
+            raise ValueError('link to unknown node {}'.format(sequence_number))
+        return Node(self, pos)
+
+    def _node_class(self, type_name):
+        for module in self._modules:
+            typ = getattr(module, type_name, None)
+            if typ is not None:
+                return typ
+        raise TypeError('no node class found for {}'.format(type_name))
+
+
+class Node:
+    """View over a serialized node. Its fields are decoded when accessed, and never cached."""
+
+    __slots__ = ('_tree', '_offset', '_fields')
+
+    def __init__(self, tree, offset, fields=None):
+        super().__init__()
+        self._tree = tree
+        self._offset = offset
+        self._fields = fields
+
+    def _field_offsets(self):
+        if self._fields is None:
+            self._fields = _map_offsets(self._tree._buffer, self._offset)
+        return self._fields
+
+    @property
+    def type_name(self):
+        """The name of the node class, e.g. 'Program'."""
+        return _decode(self._tree._buffer, self._field_offsets()['@t'])
+
+    def fields(self):
+        """Returns the names of the fields of this node."""
+        return [name for name in self._field_offsets() if name[0] not in '@{']
+
+    def materialize(self):
+        """
+        Fully deserializes this node into an instance of the generated node class.
+        Links to nodes outside of this subtree cannot be resolved,
+        so this is meant for link-free subtrees, such as types and values.
+        """
+        return self._tree._node_class(self.type_name).deserialize(_decode(self._tree._buffer, self._offset))
+
+    def __getattr__(self, name):
+        if name.startswith('_'):
+            raise AttributeError(name)
+        pos = self._field_offsets().get(name)
+        if pos is None:
+            raise AttributeError('{} has no field {}'.format(self.type_name, name))
+        return self._tree._value(pos)
+
+    def __eq__(self, other):
+        return isinstance(other, Node) and self._tree is other._tree and self._offset == other._offset
+
+    def __hash__(self):
+        return hash((id(self._tree), self._offset))
+
+    def __repr__(self):
+        return '<lazy {} at offset {}>'.format(self.type_name, self._offset)
+
+
+class NodeList(Sequence):
+    """View over a serialized list of nodes. The element offsets are indexed on first access."""
+
+    __slots__ = ('_tree', '_offset', '_elements')
+
+    def __init__(self, tree, offset):
+        super().__init__()
+        self._tree = tree
+        self._offset = offset
+        self._elements = None
+
+    def _element_offsets(self):
+        if self._elements is None:
+            self._elements = list(_items(self._tree._buffer, self._offset))
+        return self._elements
+
+    def __len__(self):
+        return len(self._element_offsets())
+
+    def __getitem__(self, index):
+        if isinstance(index, slice):
+            return [Node(self._tree, pos) for pos in self._element_offsets()[index]]
+        return Node(self._tree, self._element_offsets()[index])
+
+    def __repr__(self):
+        return '<lazy list of {} nodes>'.format(len(self))
@@ -11,6 +11,19 @@
 
 namespace cqasm::annotations {
 
+/**
+ * Constructs a file name, holding a new copy of the given name.
+ */
+FileName::FileName(std::string_view name)
+: name_{ std::make_shared<const std::string>(name) } {}
+
+/**
+ * Stream << overload for file names.
+ */
+std::ostream &operator<<(std::ostream &os, const FileName &object) {
+    return os << object.str();
+}
+
 SourceLocation::Range::Range(const Index &f, const Index &l)
 : first{ f } , last{ l } {
     last = std::max<Index>(last, first);
@@ -20,13 +33,29 @@ SourceLocation::Range::Range(const Index &f, const Index &l)
  * Constructs a source location object.
  */
 SourceLocation::SourceLocation(const std::optional<std::string> &file_name_, const Range &range_)
-: file_name{ file_name_ }
-, range{ range_ } {
-    if (file_name.has_value() && file_name.value().empty()) {
-        file_name = std::nullopt;
+: range{ range_ } {
+    if (file_name_.has_value() && !file_name_.value().empty()) {
+        file_name = FileName{ file_name_.value() };
+    }
+}
+
+/**
+ * Constructs a source location object sharing an existing file name.
+ * This is what the parsers use, so that they construct the file name only once per parse.
+ */
+SourceLocation::SourceLocation(const std::optional<FileName> &file_name_, const Range &range_)
+: range{ range_ } {
+    if (file_name_.has_value() && !file_name_.value().str().empty()) {
+        file_name = file_name_;
     }
 }
 
+/**
+ * Constructs a source location object without a file name.
+ */
+SourceLocation::SourceLocation(std::nullopt_t, const Range &range_)
+: range{ range_ } {}
+
 /**
  * Expands the location range to contain the given location in the source file.
  */
@@ -40,7 +69,11 @@ void SourceLocation::expand_to_include(const Index &index) {
  */
 std::ostream &operator<<(std::ostream &os, const SourceLocation &object) {
     // Print file name.
-    os << object.file_name.value_or(unknown_file_name);
+    if (object.file_name.has_value()) {
+        os << object.file_name.value();
+    } else {
+        os << unknown_file_name;
+    }
 
     // Special case for when only the source file name is known.
     if (!object.range.first.line) {
@@ -100,7 +100,7 @@ std::string Error::to_json() const {
                 R"(}})"
                 R"(,"message":"{1}")"
             R"(}}])",
-            cqasm::utils::url_encode(location_->file_name.value()),
+            cqasm::utils::url_encode(location_->file_name->str()),
             cqasm::utils::json_encode(unknown_error_message)
         );
     }
@@ -0,0 +1,86 @@
+/** \file
+ * Implementation for \ref include/cqasm-mapped-file.hpp "cqasm-mapped-file.hpp".
+ */
+
+#include "cqasm-mapped-file.hpp"
+#include "cqasm-utils.hpp"  // read_file
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>  // open
+#include <sys/mman.h>  // mmap, munmap
+#include <sys/stat.h>  // fstat
+#include <unistd.h>  // close
+#endif
+
+
+namespace cqasm::utils {
+
+/**
+ * Maps the given file.
+ * Throws a ParseError if the file cannot be opened.
+ */
+MappedFile::MappedFile(const std::string &file_path) {
+#ifdef _WIN32
+    if (auto file = CreateFileA(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL, nullptr); file != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER file_size{};
+        if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0) {
+            if (auto mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr)) {
+                // The view keeps a reference to the mapping object
+                if (auto address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) {
+                    address_ = address;
+                    size_ = static_cast<std::size_t>(file_size.QuadPart);
+                }
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+    }
+#else
+    if (auto fd = open(file_path.c_str(), O_RDONLY); fd != -1) {
+        struct stat file_stat{};
+        if (fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0) {
+            auto size = static_cast<std::size_t>(file_stat.st_size);
+            if (auto address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0); address != MAP_FAILED) {
+                address_ = address;
+                size_ = size;
+            }
+        }
+        close(fd);
+    }
+#endif
+    // Empty files cannot be mapped, and some platforms or file systems do not support mapping at all.
+    // read_file also takes care of reporting files that cannot be opened
+    if (!address_) {
+        contents_ = read_file(file_path);
+    }
+}
+
+/**
+ * Unmaps the file.
+ */
+MappedFile::~MappedFile() {
+    if (address_) {
+#ifdef _WIN32
+        UnmapViewOfFile(address_);
+#else
+        munmap(address_, size_);
+#endif
+    }
+}
+
+/**
+ * Returns the contents of the file.
+ * The returned view is valid for as long as this object is alive.
+ */
+std::string_view MappedFile::data() const {
+    return address_
+        ? std::string_view{ static_cast<const char *>(address_), size_ }
+        : std::string_view{ contents_ };
+}
+
+} // namespace cqasm::utils
@@ -2,11 +2,16 @@
  * Implementation for \ref include/cqasm-utils.hpp "cqasm-utils.hpp".
  */
 
+#include "cqasm-error.hpp"
 #include "cqasm-utils.hpp"
 
 #include <algorithm>  // transform
 #include <cctype>  // isalnum, tolower, toupper
+#include <cerrno>  // errno
+#include <cstdint>  // uint64_t
+#include <cstring>  // strerror
 #include <fmt/format.h>
+#include <fstream>  // ifstream
 #include <range/v3/algorithm/equal.hpp>
 #include <range/v3/range/conversion.hpp>  // to
 #include <range/v3/view/transform.hpp>
@@ -26,12 +31,27 @@ std::string to_lowercase(const std::string &name) {
 /**
  * Case-insensitive string compare.
  */
-bool equal_case_insensitive(const std::string &lhs, const std::string &rhs) {
+bool equal_case_insensitive(std::string_view lhs, std::string_view rhs) {
     return ranges::equal(lhs, rhs, [](unsigned char l, unsigned char r) {
         return std::tolower(l) == std::tolower(r);
     });
 }
 
+/**
+ * Case-insensitive string hash, consistent with equal_case_insensitive.
+ * It hashes the lowercase form of the string without building it,
+ * so that case-insensitive unordered containers can be searched without allocating.
+ */
+std::size_t CaseInsensitiveHash::operator()(std::string_view str) const noexcept {
+    // 64-bit FNV-1a
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : str) {
+        hash ^= static_cast<std::uint64_t>(std::tolower(c));
+        hash *= 1099511628211ULL;
+    }
+    return static_cast<std::size_t>(hash);
+}
+
 /**
  * Encodes a string in URL format.
  */
@@ -58,4 +78,23 @@ std::string json_encode(const std::string &str) {
     return ret;
 }
 
+/**
+ * Reads the whole contents of a file into a string.
+ * Throws a ParseError if the file cannot be read.
+ */
+std::string read_file(const std::string &file_path) {
+    std::ifstream ifs{ file_path, std::ios::binary | std::ios::ate };
+    if (!ifs) {
+        throw error::ParseError{
+            fmt::format("read_file failed to open input file '{}': {}.", file_path, std::strerror(errno)) };
+    }
+    auto size = static_cast<std::streamoff>(ifs.tellg());
+    auto ret = std::string(static_cast<size_t>(std::max(size, std::streamoff{ 0 })), '\0');
+    ifs.seekg(0);
+    if (size < 0 || !ifs.read(ret.data(), static_cast<std::streamsize>(ret.size()))) {
+        throw error::ParseError{ fmt::format("read_file failed to read input file '{}'.", file_path) };
+    }
+    return ret;
+}
+
 } // namespace cqasm::utils
@@ -9,6 +9,8 @@
 #include "cqasm-version-lexer.hpp"
 #include "flex-bison-parser-constants.hpp"
 
+#include <algorithm>  // min
+#include <cstring>  // memcpy
 #include <fmt/format.h>
 #include <memory>
 
@@ -43,14 +45,14 @@ Version::Version(const char *version)
 : Version(std::string{ version }) {}
 
 /**
- * Compares this version against the other version.
+ * Compares this version against the other version, given by its components.
  * Returns:
  *   1 if this version is newer than the other,
  *   -1 if this version is older than the other, or
  *   0 if both versions are the same.
  * When there is a mismatch in the number of components between the versions, missing components are interpreted as 0.
  */
-int Version::compare(const Version &other) const {
+int Version::compare(std::span<const std::int64_t> other) const {
     for (size_t i = 0; i < this->size() || i < other.size(); i++) {
         auto lhs = (i < this->size())
             ? (*this)[i]
@@ -118,18 +120,29 @@ void ScannerFlexBisonFile::parse(const std::string &file_name, Version &version)
 }
 
 
-ScannerFlexBisonString::ScannerFlexBisonString(const char *data)
+/**
+ * Copies up to max_size bytes of the remaining data into buffer.
+ * Returns the number of bytes copied, 0 meaning end of input.
+ */
+std::size_t StringInput::read(char *buffer, std::size_t max_size) {
+    auto size = std::min(max_size, data.size());
+    std::memcpy(buffer, data.data(), size);
+    data.remove_prefix(size);
+    return size;
+}
+
+
+ScannerFlexBisonString::ScannerFlexBisonString(std::string_view data)
 : data_{ data } {}
 
 ScannerFlexBisonString::~ScannerFlexBisonString() {}
 
 void ScannerFlexBisonString::parse(const std::string &file_name, Version &version) const {
-    auto buffer = cqasm_version__scan_string(data_, static_cast<yyscan_t>(scanner_));
-    if (!buffer) {
-        throw error::ParseError("ScannerFlexBisonString failed to scan input data string.");
-    }
+    // The lexer reads from the input through YY_INPUT, and stops right after the version statement
+    StringInput input{ data_ };
+    cqasm_version_set_extra(&input, static_cast<yyscan_t>(scanner_));
     parse_(file_name, version);
-    cqasm_version__delete_buffer(buffer, static_cast<yyscan_t>(scanner_));
+    cqasm_version_set_extra(nullptr, static_cast<yyscan_t>(scanner_));
 }
 
 
@@ -165,7 +178,15 @@ Version parse_file(FILE *fp, const std::optional<std::string> &file_name) {
  * Parse the given string as a file to get its version number.
  */
 Version parse_string(const std::string &data, const std::optional<std::string> &file_name) {
-    auto scanner_up = std::make_unique<ScannerFlexBisonString>(data.c_str());
+    return parse_view(data, file_name);
+}
+
+/**
+ * Same as parse_string, but scans a caller-owned buffer, e.g. a memory-mapped file, without copying it.
+ * The data only has to stay alive for the duration of the call.
+ */
+Version parse_view(std::string_view data, const std::optional<std::string> &file_name) {
+    auto scanner_up = std::make_unique<ScannerFlexBisonString>(data);
     return ParseHelper(std::move(scanner_up), file_name).parse();
 }
 
@@ -2,121 +2,147 @@
 #include "v1x/cqasm-analyzer-helper.hpp"
 #include "v1x/cqasm-values.hpp"
 
+#include <algorithm>  // max, min
 #include <fmt/format.h>
+#include <iterator>  // prev
 #include <map>
-#include <unordered_set>
 
 
 namespace cqasm::v1x::analyzer {
 
 /**
- * Analyzes the given AST using the given analyzer.
+ * Prepares the analysis of a program using the given analyzer,
+ * handing the analyzed bundles to the given callback, if any, instead of adding them to their subcircuit.
  */
-AnalyzerHelper::AnalyzerHelper(const Analyzer &analyzer, const ast::Program &ast)
+AnalyzerHelper::AnalyzerHelper(const Analyzer &analyzer, BundleCallback bundle_callback)
 : analyzer(analyzer)
 , result()
-, scope_stack( { Scope(analyzer.mappings, analyzer.functions, analyzer.instruction_set) } )
+, api_has_bundle_ext(analyzer.api_version >= version::VersionLiteral{ "1.2" })
+, api_has_dynamic_expressions(analyzer.api_version >= version::VersionLiteral{ "1.1" })
+, bundle_callback(std::move(bundle_callback))
+{
+    // The global scope only stores the mappings added by the program, on top of those of the analyzer.
+    scope_stack.emplace_back(resolver::MappingTable{ &analyzer.mappings }, analyzer.functions, analyzer.instruction_set);
+
+    // Construct the program node.
+    result.root.set(tree::make<semantic::Program>());
+    result.root->api_version = analyzer.api_version;
+}
+
+/**
+ * Analyzes the given AST using the given analyzer.
+ */
+AnalyzerHelper::AnalyzerHelper(const Analyzer &analyzer, const ast::Program &ast)
+: AnalyzerHelper(analyzer)
 {
     try {
-        // Construct the program node.
-        result.root.set(tree::make<semantic::Program>());
         result.root->copy_annotation<parser::SourceLocation>(ast);
-        result.root->api_version = analyzer.api_version;
-
-        // Check and set the version.
-        analyze_version(*ast.version);
-
-        // Handle the qubits statement.
-        // Qubit variables can be used instead of the qubits keyword,
-        // in which case num_qubits is set to 0 to indicate that it's not being used.
-        if (!ast.num_qubits.empty()) {
-            analyze_qubits(*ast.num_qubits);
-        } else if (ast.version->items < "1.1") {
-            throw error::AnalysisError{ "missing qubits statement (required until version 1.1)" };
-        } else {
-            result.root->num_qubits = 0;
-        }
-
-        // Read the statements.
+        analyze_header(*ast.version, ast.num_qubits.empty() ? nullptr : &*ast.num_qubits);
         analyze_statements(*ast.statements);
+        analyze_end();
+    } catch (error::AnalysisError &err) {
+        result.errors.push_back(std::move(err));
+    }
+}
 
-        // Resolve goto targets.
-        if (ast.version->items >= "1.2") {
+/**
+ * Analyzes the version and qubits statements, which precede all the other statements of the program.
+ * Throws an AnalysisError if the rest of the program cannot be analyzed.
+ */
+void AnalyzerHelper::analyze_header(const ast::Version &version, const ast::Expression *num_qubits) {
+    // Check and set the version.
+    analyze_version(version);
+
+    // Handle the qubits statement.
+    // Qubit variables can be used instead of the qubits keyword,
+    // in which case num_qubits is set to 0 to indicate that it's not being used.
+    if (num_qubits) {
+        analyze_qubits(*num_qubits);
+    } else if (version.items < version::VersionLiteral{ "1.1" }) {
+        throw error::AnalysisError{ "missing qubits statement (required until version 1.1)" };
+    } else {
+        result.root->num_qubits = 0;
+    }
+}
 
-            // Figure out all the subcircuit names and check for duplicates.
-            std::map<std::string, tree::Maybe<semantic::Subcircuit>> subcircuits;
-            for (const auto &subcircuit : result.root->subcircuits) {
-                try {
-                    auto insert_result = subcircuits.insert({subcircuit->name, subcircuit});
-                    if (!insert_result.second) {
-                        std::ostringstream ss;
-                        ss << "duplicate subcircuit name \"" << subcircuit->name << "\"";
-                        if (auto loc = insert_result.first->second->get_annotation_ptr<parser::SourceLocation>()) {
-                            ss << "; previous definition was at " << *loc;
-                        }
-                        throw error::AnalysisError{ ss.str() };
+/**
+ * Finishes the analysis once all the statements of the program have been analyzed,
+ * resolving the goto targets (1.2+) and saving the global mappings into the program.
+ */
+void AnalyzerHelper::analyze_end() {
+    // Resolve goto targets.
+    if (has_structured_control_flow) {
+
+        // Figure out all the subcircuit names and check for duplicates.
+        std::map<std::string, tree::Maybe<semantic::Subcircuit>> subcircuits;
+        for (const auto &subcircuit : result.root->subcircuits) {
+            try {
+                auto insert_result = subcircuits.insert({subcircuit->name, subcircuit});
+                if (!insert_result.second) {
+                    std::ostringstream ss;
+                    ss << "duplicate subcircuit name \"" << subcircuit->name << "\"";
+                    if (auto loc = insert_result.first->second->get_annotation_ptr<parser::SourceLocation>()) {
+                        ss << "; previous definition was at " << *loc;
                     }
-                } catch (error::AnalysisError &err) {
-                    err.context(*subcircuit);
-                    result.errors.push_back(std::move(err));
+                    throw error::AnalysisError{ ss.str() };
                 }
+            } catch (error::AnalysisError &err) {
+                err.context(*subcircuit);
+                result.errors.push_back(std::move(err));
             }
+        }
 
-            // Resolve the goto instruction targets.
-            for (const auto &it : gotos) {
-                try {
-                    auto it2 = subcircuits.find(it.second);
-                    if (it2 == subcircuits.end()) {
-                        throw error::AnalysisError{
-                            fmt::format("failed to resolve subcircuit \"{}\"", it.second) };
-                    }
-                    it.first->target = it2->second;
-                } catch (error::AnalysisError &err) {
-                    err.context(*it.first);
-                    result.errors.push_back(std::move(err));
+        // Resolve the goto instruction targets.
+        for (const auto &it : gotos) {
+            try {
+                auto it2 = subcircuits.find(it.second);
+                if (it2 == subcircuits.end()) {
+                    throw error::AnalysisError{
+                        fmt::format("failed to resolve subcircuit \"{}\"", it.second) };
                 }
+                it.first->target = it2->second;
+            } catch (error::AnalysisError &err) {
+                err.context(*it.first);
+                result.errors.push_back(std::move(err));
             }
-
         }
 
-        // Save the list of final mappings.
-        for (const auto &it : get_current_scope().mappings.get_table()) {
-            const auto &name = it.first;
-            const auto &value = it.second.first;
-            const auto &ast_node = it.second.second;
-
-            // Ignore predefined and implicit mappings.
-            if (ast_node.empty()) {
-                continue;
-            }
-
-            // Analyze any annotations attached to the mapping.
-            auto annotations = analyze_annotations(ast_node->annotations);
+    }
 
-            // Construct the mapping object and copy the source location.
-            auto mapping = tree::make<semantic::Mapping>(
-                name, value,
-                analyze_annotations(ast_node->annotations)
-            );
-            mapping->copy_annotation<parser::SourceLocation>(*ast_node);
-            result.root->mappings.add(mapping);
+    // Save the list of final mappings.
+    for (const auto &it : get_current_scope().mappings.get_table()) {
+        const auto &name = it.first;
+        const auto &value = it.second.first;
+        const auto &ast_node = it.second.second;
 
+        // Ignore predefined and implicit mappings.
+        if (ast_node.empty()) {
+            continue;
         }
 
-        // The iteration order over the mapping table is undefined,
-        // because it's backed by an unordered_map.
-        // To get a deterministic tree, sort by source location.
-        std::sort(
-            result.root->mappings.begin(), result.root->mappings.end(),
-            [](const tree::One<semantic::Mapping> &lhs, const tree::One<semantic::Mapping> &rhs) -> bool {
-                auto lhs_source_location = lhs->get_annotation_ptr<parser::SourceLocation>();
-                auto rhs_source_location = rhs->get_annotation_ptr<parser::SourceLocation>();
-                return lhs_source_location && rhs_source_location && *lhs_source_location < *rhs_source_location;
-            });
+        // Analyze any annotations attached to the mapping.
+        auto annotations = analyze_annotations(ast_node->annotations);
+
+        // Construct the mapping object and copy the source location.
+        auto mapping = tree::make<semantic::Mapping>(
+            name, value,
+            analyze_annotations(ast_node->annotations)
+        );
+        mapping->copy_annotation<parser::SourceLocation>(*ast_node);
+        result.root->mappings.add(mapping);
 
-    } catch (error::AnalysisError &err) {
-        result.errors.push_back(std::move(err));
     }
+
+    // The iteration order over the mapping table is undefined,
+    // because it's backed by an unordered_map.
+    // To get a deterministic tree, sort by source location.
+    std::sort(
+        result.root->mappings.begin(), result.root->mappings.end(),
+        [](const tree::One<semantic::Mapping> &lhs, const tree::One<semantic::Mapping> &rhs) -> bool {
+            auto lhs_source_location = lhs->get_annotation_ptr<parser::SourceLocation>();
+            auto rhs_source_location = rhs->get_annotation_ptr<parser::SourceLocation>();
+            return lhs_source_location && rhs_source_location && *lhs_source_location < *rhs_source_location;
+        });
 }
 
 /**
@@ -148,6 +174,11 @@ void AnalyzerHelper::analyze_version(const ast::Version &ast) {
         result.errors.push_back(std::move(err));
     }
     result.root->version->copy_annotation<parser::SourceLocation>(ast);
+
+    // Compute the features of the file version once, instead of for every statement.
+    const auto &file_version = result.root->version->items;
+    has_variables = file_version >= version::VersionLiteral{ "1.1" };
+    has_structured_control_flow = file_version >= version::VersionLiteral{ "1.2" };
 }
 
 /**
@@ -167,11 +198,11 @@ void AnalyzerHelper::analyze_qubits(const ast::Expression &count) {
         }
 
         // Construct the special q and b mappings, that map to the whole qubit and measurement register respectively.
-        tree::Many<values::ConstInt> all_qubits;
-        for (primitives::Int i = 0; i < result.root->num_qubits; i++) {
-            auto vi = tree::make<values::ConstInt>(i);
-            vi->copy_annotation<parser::SourceLocation>(count);
-            all_qubits.add(vi);
+        tree::Many<values::IndexRange> all_qubits;
+        if (result.root->num_qubits > 0) {
+            auto range = tree::make<values::IndexRange>(0, result.root->num_qubits - 1);
+            range->copy_annotation<parser::SourceLocation>(count);
+            all_qubits.add(range);
         }
         get_current_scope().mappings.add("q", tree::make<values::QubitRefs>(all_qubits));
         get_current_scope().mappings.add("b", tree::make<values::BitRefs>(all_qubits));
@@ -194,7 +225,7 @@ tree::Maybe<semantic::Subcircuit> AnalyzerHelper::get_current_subcircuit(const t
     if (result.root->subcircuits.empty()) {
         auto subcircuit_node = tree::make<semantic::Subcircuit>("", 1);
         subcircuit_node->copy_annotation<parser::SourceLocation>(source);
-        if (analyzer.api_version >= "1.2") {
+        if (api_has_bundle_ext) {
             subcircuit_node->body = tree::make<semantic::Block>();
         }
         result.root->subcircuits.add(subcircuit_node);
@@ -259,31 +290,40 @@ void AnalyzerHelper::add_to_current_block(const tree::Maybe<semantic::Statement>
  */
 void AnalyzerHelper::analyze_statements(const ast::StatementList &statements) {
     for (const auto &statement : statements.items) {
-        try {
-            if (auto bundle = statement->as_bundle()) {
-                if (analyzer.api_version >= "1.2") {
-                    analyze_bundle_ext(*bundle);
-                } else {
-                    analyze_bundle(*bundle);
-                }
-            } else if (auto mapping = statement->as_mapping()) {
-                analyze_mapping(*mapping);
-            } else if (auto variables = statement->as_variables()) {
-                analyze_variables(*variables);
-            } else if (auto subcircuit = statement->as_subcircuit()) {
-                analyze_subcircuit(*subcircuit);
-            } else if (auto structured = statement->as_structured()) {
-                if (result.root->version->items < "1.2") {
-                    throw error::AnalysisError{ "structured control-flow is not supported (need version 1.2+)" };
-                }
-                analyze_structured(*structured);
+        analyze_statement(*statement);
+    }
+}
+
+/**
+ * Analyzes the given statement,
+ * adding the analyzed statement to the current subcircuit (API 1.0/1.1) or block (API 1.2+).
+ * If an error occurs, the message is added to the result error vector, and nothing is added.
+ */
+void AnalyzerHelper::analyze_statement(const ast::Statement &statement) {
+    try {
+        if (auto bundle = statement.as_bundle()) {
+            if (api_has_bundle_ext) {
+                analyze_bundle_ext(*bundle);
             } else {
-                throw std::runtime_error("unexpected statement node");
+                analyze_bundle(*bundle);
             }
-        } catch (error::AnalysisError &err) {
-            err.context(*statement);
-            result.errors.push_back(std::move(err));
+        } else if (auto mapping = statement.as_mapping()) {
+            analyze_mapping(*mapping);
+        } else if (auto variables = statement.as_variables()) {
+            analyze_variables(*variables);
+        } else if (auto subcircuit = statement.as_subcircuit()) {
+            analyze_subcircuit(*subcircuit);
+        } else if (auto structured = statement.as_structured()) {
+            if (!has_structured_control_flow) {
+                throw error::AnalysisError{ "structured control-flow is not supported (need version 1.2+)" };
+            }
+            analyze_structured(*structured);
+        } else {
+            throw std::runtime_error("unexpected statement node");
         }
+    } catch (error::AnalysisError &err) {
+        err.context(statement);
+        result.errors.push_back(std::move(err));
     }
 }
 
@@ -300,9 +340,8 @@ tree::Maybe<semantic::Block> AnalyzerHelper::analyze_subblock(
     block.emplace();
 
     // Create a scope for the block.
-    scope_stack.emplace_back(get_current_scope());
-    get_current_scope().block = block;
-    get_current_scope().within_loop |= is_loop;
+    // It only stores the mappings added within the block, and refers to the enclosing scope for the rest.
+    scope_stack.emplace_back(get_current_scope(), block, is_loop);
 
     // Analyze the statements within the block.
     // The statements will be added to the current scope, which we just updated.
@@ -315,7 +354,8 @@ tree::Maybe<semantic::Block> AnalyzerHelper::analyze_subblock(
 }
 
 /**
- * Analyzes the given bundle and, if valid, adds it to the current subcircuit using API version 1.0/1.1.
+ * Analyzes the given bundle and, if valid, adds it to the current subcircuit using API version 1.0/1.1,
+ * or hands it to the bundle callback when streaming.
  * If an error occurs, the message is added to the result error vector, and nothing is added to the subcircuit.
  */
 void AnalyzerHelper::analyze_bundle(const ast::Bundle &bundle) {
@@ -326,6 +366,10 @@ void AnalyzerHelper::analyze_bundle(const ast::Bundle &bundle) {
         // but the less random keywords there are, the better.
         if (bundle.items.size() == 1) {
             if (utils::equal_case_insensitive(bundle.items[0]->name->name, "error_model")) {
+                // The bundles handed over already could not take it into account.
+                if (has_streamed_bundles) {
+                    throw error::AnalysisError{ "the error model must precede the first bundle when streaming" };
+                }
                 analyze_error_model(*bundle.items[0]);
                 return;
             }
@@ -375,8 +419,14 @@ void AnalyzerHelper::analyze_bundle(const ast::Bundle &bundle) {
         node->annotations = analyze_annotations(bundle.annotations);
         node->copy_annotation<parser::SourceLocation>(bundle);
 
-        // Add the node to the last subcircuit.
-        get_current_subcircuit(bundle)->bundles.add(node);
+        // Add the node to the last subcircuit, or hand it over when streaming.
+        auto subcircuit = get_current_subcircuit(bundle);
+        if (bundle_callback) {
+            has_streamed_bundles = true;
+            bundle_callback(*result.root, *subcircuit, std::move(node));
+        } else {
+            subcircuit->bundles.add(node);
+        }
 
     } catch (error::AnalysisError &err) {
         err.context(bundle);
@@ -512,16 +562,25 @@ tree::Maybe<semantic::Instruction> AnalyzerHelper::analyze_instruction(const ast
             node->condition.set(tree::make<values::ConstBool>(true));
         }
 
-        // Enforce qubit uniqueness if the instruction requires us to.
+        // Enforce qubit uniqueness if the instruction requires us to. The
+        // qubits used so far are kept as disjoint ranges, mapping the first
+        // index of each range to its last index. The reported index is the
+        // first one of a range that was already used.
         if (!node->instruction.empty() && !node->instruction->allow_reused_qubits) {
-            std::unordered_set<primitives::Int> qubits_used;
+            std::map<primitives::Int, primitives::Int> qubits_used;
             for (const auto &operand : operands) {
                 if (auto x = operand->as_qubit_refs()) {
-                    for (const auto &index : x->index) {
-                        if (!qubits_used.insert(index->value).second) {
+                    for (const auto &range : x->index) {
+                        auto next = qubits_used.upper_bound(range->first);
+                        if (next != qubits_used.begin() && std::prev(next)->second >= range->first) {
                             throw error::AnalysisError{
-                                fmt::format("qubit with index {} is used more than once", index->value) };
+                                fmt::format("qubit with index {} is used more than once", range->first) };
                         }
+                        if (next != qubits_used.end() && next->first <= range->last) {
+                            throw error::AnalysisError{
+                                fmt::format("qubit with index {} is used more than once", next->first) };
+                        }
+                        qubits_used.emplace(range->first, range->last);
                     }
                 }
             }
@@ -536,18 +595,19 @@ tree::Maybe<semantic::Instruction> AnalyzerHelper::analyze_instruction(const ast
             size_t num_refs = 0;
             const parser::SourceLocation *num_refs_loc = nullptr;
             for (const auto &operand : operands) {
-                const tree::Many<values::ConstInt> *indices = nullptr;
+                const tree::Many<values::IndexRange> *indices = nullptr;
                 if (auto qr = operand->as_qubit_refs()) {
                     indices = &qr->index;
                 } else if (auto br = operand->as_bit_refs()) {
                     indices = &br->index;
                 }
                 if (indices) {
+                    auto num_indices = static_cast<size_t>(values::size_of(*indices));
                     if (!num_refs) {
-                        num_refs = indices->size();
-                    } else if (num_refs != indices->size()) {
+                        num_refs = num_indices;
+                    } else if (num_refs != num_indices) {
                         std::ostringstream ss;
-                        ss << "the number of indices (" << indices->size() << ") ";
+                        ss << "the number of indices (" << num_indices << ") ";
                         ss << "doesn't match previously found number of indices ";
                         ss << "(" << num_refs << ")";
                         if (num_refs_loc) {
@@ -807,7 +867,7 @@ void AnalyzerHelper::analyze_mapping(const ast::Mapping &mapping) {
 void AnalyzerHelper::analyze_variables(const ast::Variables &variables) {
     try {
         // Check version compatibility.
-        if (result.root->version->items < "1.1") {
+        if (!has_variables) {
             throw error::AnalysisError{ "variables are only supported from cQASM 1.1 onwards" };
         }
 
@@ -876,7 +936,7 @@ void AnalyzerHelper::analyze_subcircuit(const ast::Subcircuit &subcircuit) {
             tree::Any<semantic::Bundle>(),
             analyze_annotations(subcircuit.annotations));
         node->copy_annotation<parser::SourceLocation>(subcircuit);
-        if (analyzer.api_version >= "1.2") {
+        if (api_has_bundle_ext) {
             node->body = tree::make<semantic::Block>();
             node->body->copy_annotation<parser::SourceLocation>(subcircuit);
         }
@@ -1250,7 +1310,7 @@ values::Value AnalyzerHelper::analyze_expression(const ast::Expression &expressi
         } else {
             throw std::runtime_error("unexpected expression node");
         }
-        if ((analyzer.api_version < "1.1") &&
+        if (!api_has_dynamic_expressions &&
             !retval.empty() &&
             (retval->as_function() || retval->as_variable_ref())) {
             throw error::AnalysisError{ "dynamic expressions are only supported from cQASM 1.1 onwards" };
@@ -1332,6 +1392,48 @@ values::Value AnalyzerHelper::analyze_matrix(const ast::MatrixLiteral &matrix_li
         "only matrices of constant real or complex numbers are currently supported" };
 }
 
+/**
+ * Maps ranges of positions within the given index ranges to the indices at
+ * those positions. Every range of positions maps to one or more index ranges,
+ * which keep the source location of the range of positions.
+ */
+static tree::Many<values::IndexRange> map_index_ranges(
+    const tree::Many<values::IndexRange> &positions,
+    const tree::Many<values::IndexRange> &indices
+) {
+    tree::Many<values::IndexRange> retval;
+    for (const auto &position : positions) {
+        auto first_mapped = retval.size();
+
+        // Position of the first index of the current index range.
+        primitives::Int offset = 0;
+        for (const auto &range : indices) {
+            auto size = range->last - range->first + 1;
+            auto first = std::max(position->first, offset);
+            auto last = std::min(position->last, offset + size - 1);
+            if (first <= last) {
+                first += range->first - offset;
+                last += range->first - offset;
+                if (retval.size() > first_mapped && retval[retval.size() - 1]->last + 1 == first) {
+
+                    // Continues the previous index range of this range of positions.
+                    retval[retval.size() - 1]->last = last;
+
+                } else {
+                    auto mapped = tree::make<values::IndexRange>(first, last);
+                    mapped->copy_annotation<parser::SourceLocation>(*position);
+                    retval.add(mapped);
+                }
+            }
+            offset += size;
+            if (offset > position->last) {
+                break;
+            }
+        }
+    }
+    return retval;
+}
+
 /**
  * Parses an index operator. Always returns a filled value or throws an error.
  */
@@ -1340,20 +1442,14 @@ values::Value AnalyzerHelper::analyze_index(const ast::Index &index) {
     if (auto qubit_refs = expr->as_qubit_refs()) {
 
         // Qubit refs.
-        auto indices = analyze_index_list(*index.indices, qubit_refs->index.size());
-        for (const auto &idx : indices) {
-            idx->value = qubit_refs->index[idx->value]->value;
-        }
-        return tree::make<values::QubitRefs>(indices);
+        auto positions = analyze_index_list(*index.indices, static_cast<size_t>(values::size_of(qubit_refs->index)));
+        return tree::make<values::QubitRefs>(map_index_ranges(positions, qubit_refs->index));
 
     } else if (auto bit_refs = expr->as_bit_refs()) {
 
         // Measurement bit refs.
-        auto indices = analyze_index_list(*index.indices, bit_refs->index.size());
-        for (const auto &idx : indices) {
-            idx->value = bit_refs->index[idx->value]->value;
-        }
-        return tree::make<values::BitRefs>(indices);
+        auto positions = analyze_index_list(*index.indices, static_cast<size_t>(values::size_of(bit_refs->index)));
+        return tree::make<values::BitRefs>(map_index_ranges(positions, bit_refs->index));
 
     } else {
 
@@ -1364,10 +1460,11 @@ values::Value AnalyzerHelper::analyze_index(const ast::Index &index) {
 }
 
 /**
- * Parses an index list.
+ * Parses an index list into ranges of positions, checking that they are in
+ * range of a list of the given size.
  */
-tree::Many<values::ConstInt> AnalyzerHelper::analyze_index_list(const ast::IndexList &index_list, size_t size) {
-    tree::Many<values::ConstInt> retval;
+tree::Many<values::IndexRange> AnalyzerHelper::analyze_index_list(const ast::IndexList &index_list, size_t size) {
+    tree::Many<values::IndexRange> retval;
     for (const auto &entry : index_list.items) {
         if (auto item = entry->as_index_item()) {
 
@@ -1377,7 +1474,7 @@ tree::Many<values::ConstInt> AnalyzerHelper::analyze_index_list(const ast::Index
                 throw error::AnalysisError{
                     fmt::format("index {} out of range (size {})", index, size), item };
             }
-            auto index_val = tree::make<values::ConstInt>(index);
+            auto index_val = tree::make<values::IndexRange>(index, index);
             index_val->copy_annotation<parser::SourceLocation>(*item);
             retval.add(index_val);
 
@@ -1397,11 +1494,9 @@ tree::Many<values::ConstInt> AnalyzerHelper::analyze_index_list(const ast::Index
             if (first > last) {
                 throw error::AnalysisError{ "last index is lower than first index", range };
             }
-            for (auto index = first; index <= last; index++) {
-                auto index_val = tree::make<values::ConstInt>(index);
-                index_val->copy_annotation<parser::SourceLocation>(*range);
-                retval.add(index_val);
-            }
+            auto range_val = tree::make<values::IndexRange>(first, last);
+            range_val->copy_annotation<parser::SourceLocation>(*range);
+            retval.add(range_val);
 
         } else {
             throw std::runtime_error{ "unknown IndexEntry AST node" };
@@ -4,6 +4,7 @@
 
 #define _USE_MATH_DEFINES
 
+#include "cqasm-mapped-file.hpp"
 #include "cqasm-tree.hpp"  // signed_size_t
 #include "cqasm-utils.hpp"
 #include "v1x/cqasm-analyzer.hpp"
@@ -14,6 +15,7 @@
 
 #include <cmath>
 #include <fmt/format.h>
+#include <iterator>  // back_inserter
 #include <utility>
 
 
@@ -41,7 +43,7 @@ ast::One<semantic::Program> AnalysisResult::unwrap(std::ostream &out) const {
 Analyzer::Analyzer(const primitives::Version &api_version)
     : api_version(api_version), resolve_instructions(false), resolve_error_model(false)
 {
-    if (api_version > "1.2") {
+    if (api_version > version::VersionLiteral{ "1.2" }) {
         throw std::invalid_argument("this analyzer only supports up to cQASM 1.2");
     }
 }
@@ -178,27 +180,43 @@ AnalysisResult Analyzer::analyze(
     const std::function<version::Version()> &version_parser,
     const std::function<parser::ParseResult()> &parser) {
 
-    AnalysisResult result;
+    if (AnalysisResult result; !check_file_version(version_parser, result)) {
+        return result;
+    }
+    return analyze(parser());
+}
+
+/**
+ * Checks the version returned by the given version parser against the API version.
+ * Returns whether the file can be analyzed, pushing an error into the given result otherwise.
+ */
+bool Analyzer::check_file_version(
+    const std::function<version::Version()> &version_parser,
+    AnalysisResult &result) const {
+
     try {
         if (auto version = version_parser(); version > api_version) {
             result.errors.emplace_back(fmt::format(
                 "cQASM file version is {}, but at most {} is supported here", version, api_version));
-            return result;
+            return false;
         }
     } catch (error::AnalysisError &err) {
         result.errors.push_back(std::move(err));
-        return result;
+        return false;
     }
-    return analyze(parser());
+    return true;
 }
 
 /**
  * Parses and analyzes the given file.
+ * The file is mapped only once, and its contents shared by the version check and the parser.
  */
 AnalysisResult Analyzer::analyze_file(const std::string &file_name) {
+    // The file is mapped only once, by the version parser closure, which is always run first
+    std::optional<utils::MappedFile> file{};
     return analyze(
-        [=](){ return version::parse_file(file_name); },
-        [=](){ return parser::parse_file(file_name); }
+        [&](){ file.emplace(file_name); return version::parse_view(file->data(), file_name); },
+        [&](){ return parser::parse_view(file->data(), file_name); }
     );
 }
 
@@ -224,4 +242,97 @@ AnalysisResult Analyzer::analyze_string(const std::string &data, const std::opti
     );
 }
 
+/**
+ * Parses and analyzes in streaming mode using the given version and parser closures,
+ * for programs too large to be held in memory, such as long traces.
+ * The parser closure must parse in streaming mode, handing the statements to the given stream.
+ * Every statement is analyzed as soon as it is parsed, and the resulting bundles are handed to the callback
+ * instead of being added to their subcircuit, so that neither the AST nor the semantic tree
+ * grow with the size of the program.
+ * The returned program only holds the version, number of qubits, error model, and mappings,
+ * and the subcircuits without their bundles.
+ * The version, number of qubits, and error model are resolved before the first bundle is handed over,
+ * so the error model must be specified before it.
+ * Only the bundle-based semantic tree of API versions 1.0 and 1.1 can be streamed.
+ * Errors are returned as usual, but the bundles preceding an error may have been handed over already.
+ */
+AnalysisResult Analyzer::analyze_stream(
+    const std::function<version::Version()> &version_parser,
+    const std::function<parser::ParseResult(const parser::StatementStream &)> &parser,
+    const BundleCallback &callback) {
+
+    if (api_version >= version::VersionLiteral{ "1.2" }) {
+        throw std::invalid_argument("only the bundles of API versions 1.0 and 1.1 can be streamed");
+    }
+    if (AnalysisResult result; !check_file_version(version_parser, result)) {
+        return result;
+    }
+
+    // Analyze the statements as they are parsed.
+    // If the header cannot be analyzed, the statements are not either, as for a whole program.
+    AnalyzerHelper helper{ *this, callback };
+    bool header_analyzed = false;
+    auto parse_result = parser({
+        [&](const ast::Version &version, const ast::Expression *num_qubits) {
+            try {
+                helper.analyze_header(version, num_qubits);
+                header_analyzed = true;
+            } catch (error::AnalysisError &err) {
+                helper.result.errors.push_back(std::move(err));
+            }
+        },
+        [&](const ast::Statement &statement) {
+            if (header_analyzed) {
+                helper.analyze_statement(statement);
+            }
+        }
+    });
+
+    // As for a whole program, the semantic tree is dropped if there are parse errors.
+    if (!parse_result.errors.empty()) {
+        AnalysisResult result;
+        result.errors = std::move(parse_result.errors);
+        std::move(helper.result.errors.begin(), helper.result.errors.end(), std::back_inserter(result.errors));
+        return result;
+    }
+    if (header_analyzed) {
+        helper.analyze_end();
+    }
+    helper.result.root->copy_annotation<parser::SourceLocation>(*parse_result.root);
+    if (helper.result.errors.empty() && !helper.result.root.is_well_formed()) {
+        std::cerr << *helper.result.root;
+        throw std::runtime_error("internal error: no semantic errors returned, but semantic tree is incomplete. Tree was dumped.");
+    }
+    return helper.result;
+}
+
+/**
+ * Parses and analyzes the given file in streaming mode, see analyze_stream().
+ */
+AnalysisResult Analyzer::analyze_stream_file(const std::string &file_name, const BundleCallback &callback) {
+    // The file is mapped only once, by the version parser closure, which is always run first
+    std::optional<utils::MappedFile> file{};
+    return analyze_stream(
+        [&](){ file.emplace(file_name); return version::parse_view(file->data(), file_name); },
+        [&](const parser::StatementStream &stream){ return parser::parse_stream(file->data(), file_name, stream); },
+        callback
+    );
+}
+
+/**
+ * Parses and analyzes the given string in streaming mode, see analyze_stream().
+ * The optional file_name argument will be used only for error messages.
+ */
+AnalysisResult Analyzer::analyze_stream_string(
+    const std::string &data,
+    const std::optional<std::string> &file_name,
+    const BundleCallback &callback) {
+
+    return analyze_stream(
+        [&](){ return version::parse_string(data, file_name); },
+        [&](const parser::StatementStream &stream){ return parser::parse_stream(data, file_name, stream); },
+        callback
+    );
+}
+
 } // namespace cqasm::v1x::analyzer
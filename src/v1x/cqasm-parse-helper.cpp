@@ -3,19 +3,88 @@
  */
 
 #include "cqasm-annotations-constants.hpp"
+#include "cqasm-mapped-file.hpp"
 #include "flex-bison-parser-constants.hpp"
 #include "v1x/cqasm-parse-helper.hpp"
 #include "v1x/cqasm-parser.hpp"
 #include "v1x/cqasm-lexer.hpp"
 
+#include <algorithm>  // copy, copy_n, min
+#include <memory>  // unique_ptr
+
 
 namespace cqasm::v1x::parser {
 
+namespace {
+
+/**
+ * Returns a null-terminated copy of the given text, allocated from the given buffer.
+ */
+const char *copy_to(std::pmr::monotonic_buffer_resource &buffer, std::string_view text) {
+    auto *ret = static_cast<char *>(buffer.allocate(text.size() + 1, alignof(char)));
+    *std::copy(text.begin(), text.end(), ret) = '\0';
+    return ret;
+}
+
+}  // namespace
+
+/**
+ * Constructs an empty store, whose buffers allocate their memory from the given upstream resource.
+ */
+TokenStrings::TokenStrings(std::pmr::memory_resource *upstream)
+: buffer_{ upstream }
+, stored_{ std::pmr::monotonic_buffer_resource{ upstream }, std::pmr::monotonic_buffer_resource{ upstream } } {}
+
+/**
+ * Returns a null-terminated copy of the given text.
+ */
+const char *TokenStrings::store(std::string_view text) {
+    return copy_to(stored_[current_], text);
+}
+
+/**
+ * Returns a null-terminated copy of the given text,
+ * which is the same for all the calls with an equal text.
+ */
+const char *TokenStrings::intern(std::string_view text) {
+    if (auto it = interned_.find(text); it != interned_.end()) {
+        return it->data();
+    }
+    auto *ret = copy_to(buffer_, text);
+    interned_.emplace(ret, text.size());
+    return ret;
+}
+
+/**
+ * Releases the strings returned by store() before the previous call to this function.
+ * A streaming parse calls this after every statement, at which point only the text of the lookahead token,
+ * stored after the previous statement, may still be in use.
+ */
+void TokenStrings::recycle() {
+    current_ = 1 - current_;
+    stored_[current_].release();
+}
+
+/**
+ * Copies up to max_size bytes of the input into buffer, on behalf of the YY_INPUT macro of the scanner.
+ * The input is taken from the input view if set, and otherwise read from the given file.
+ * Returns the number of bytes copied, which is 0 at the end of the input.
+ */
+std::size_t ScannerContext::read(char *buffer, std::size_t max_size, FILE *file) {
+    if (!input.has_value()) {
+        return std::fread(buffer, 1, max_size, file);
+    }
+    auto size = std::min(max_size, input->size());
+    std::copy_n(input->data(), size, buffer);
+    input->remove_prefix(size);
+    return size;
+}
+
 /**
  * Parse the given file path.
  */
 ParseResult parse_file(const std::string &file_path) {
-    return ParseHelper(file_path, "", true).result;
+    return ParseHelper(file_path, {}, true).result;
 }
 
 /**
@@ -30,17 +99,46 @@ ParseResult parse_file(FILE *file, const std::optional<std::string> &file_name)
  * A file_name may be given in addition for use within error messages.
  */
 ParseResult parse_string(const std::string &data, const std::optional<std::string> &file_name) {
+    return parse_view(data, file_name);
+}
+
+/**
+ * Same as parse_string, but scans a caller-owned buffer, e.g. a memory-mapped file, without copying it.
+ * The data only has to stay alive for the duration of the call.
+ */
+ParseResult parse_view(std::string_view data, const std::optional<std::string> &file_name) {
     return ParseHelper(file_name, data, false).result;
 }
 
+/**
+ * Same as parse_view, but hands the statements at the top level of the program to the given stream
+ * as soon as they are parsed, and drops them afterwards, instead of adding them to the AST.
+ * The memory used by the parser is then bounded by the size of the largest statement,
+ * rather than that of the program.
+ * Nothing is handed to the stream anymore once a parse error is found.
+ */
+ParseResult parse_stream(
+    std::string_view data,
+    const std::optional<std::string> &file_name,
+    const StatementStream &stream) {
+
+    return ParseHelper(file_name, data, false, &stream).result;
+}
+
 /**
  * Parse a string or file with flex/bison.
- * If use_file is set, the file specified by file_path is read and data is ignored.
- * Otherwise, file_path is used only for error messages, and data is read instead.
+ * If use_file is set, the file specified by file_path is mapped and scanned, and data is ignored.
+ * Otherwise, file_path is used only for error messages, and data is scanned instead.
+ * The statements are handed to the given stream, if any, instead of being added to the AST.
  * Don't use this directly, use parse().
  */
-ParseHelper::ParseHelper(const std::optional<std::string> &file_path, const std::string &data, bool use_file)
+ParseHelper::ParseHelper(
+    const std::optional<std::string> &file_path,
+    std::string_view data,
+    bool use_file,
+    const StatementStream *statement_stream)
 : file_name{ file_path.value_or(annotations::unknown_file_name) }
+, stream{ statement_stream }
 {
     if (file_name.empty()) {
         file_name = annotations::unknown_file_name;
@@ -51,19 +149,21 @@ ParseHelper::ParseHelper(const std::optional<std::string> &file_path, const std:
         return;
     }
 
-    // Open the file or pass the data buffer to flex.
+    // Map the file, which only has to stay alive until the parsing is done.
+    std::optional<utils::MappedFile> file{};
     if (use_file) {
-        fptr = fopen(file_name.c_str(), "r");
-        if (!fptr) {
-            push_error(error::ParseError{
-                fmt::format("failed to open input file '{}': {}", file_name, strerror(errno)) });
+        try {
+            file.emplace(file_name);
+        } catch (const error::ParseError &error) {
+            push_error(error);
             return;
         }
-        cqasm_v1x_set_in(fptr, (yyscan_t)scanner);
-    } else {
-        buf = cqasm_v1x__scan_string(data.c_str(), (yyscan_t)scanner);
+        data = file->data();
     }
 
+    // Let the scanner pull the data from the view, instead of handing a copy of it to flex.
+    scanner_context.input = data;
+
     // Do the actual parsing.
     parse();
 }
@@ -83,7 +183,7 @@ ParseHelper::ParseHelper(const std::optional<std::string> &file_name_op, FILE *f
         return;
     }
 
-    // Open the file or pass the data buffer to flex.
+    // Let the scanner read from the file.
     cqasm_v1x_set_in(fptr, (yyscan_t)scanner);
 
     // Do the actual parsing.
@@ -95,7 +195,7 @@ ParseHelper::ParseHelper(const std::optional<std::string> &file_name_op, FILE *f
  * Returns whether this was successful.
  */
 bool ParseHelper::construct() {
-    if (int ret_code = cqasm_v1x_lex_init((yyscan_t*)&scanner); ret_code) {
+    if (int ret_code = cqasm_v1x_lex_init_extra(&scanner_context, (yyscan_t*)&scanner); ret_code) {
         push_error(error::ParseError{ fmt::format("failed to construct scanner: {}", strerror(ret_code)) });
         return false;
     }
@@ -106,6 +206,7 @@ bool ParseHelper::construct() {
  * Does the actual parsing.
  */
 void ParseHelper::parse() {
+    shared_file_name = annotations::FileName{ file_name };
     if (auto ret_code = cqasm_v1x_parse((yyscan_t) scanner, *this);
         ret_code == cqasm::parser::flex_bison_parser::error_memory_exhausted) {
         push_error(error::ParseError{ fmt::format("out of memory while parsing '{}'", file_name) });
@@ -118,18 +219,17 @@ void ParseHelper::parse() {
         std::cerr << *result.root;
         throw std::runtime_error("internal error: no parse errors returned, but AST is incomplete. AST was dumped.");
     }
+
+    // A program without statements still has a header.
+    if (stream && result.errors.empty()) {
+        stream_header();
+    }
 }
 
 /**
  * Destroys the analyzer.
  */
 ParseHelper::~ParseHelper() {
-    if (fptr) {
-        fclose(fptr);
-    }
-    if (buf) {
-        cqasm_v1x__delete_buffer((YY_BUFFER_STATE)buf, (yyscan_t)scanner);
-    }
     if (scanner) {
         cqasm_v1x_lex_destroy((yyscan_t)scanner);
     }
@@ -149,4 +249,33 @@ void ParseHelper::push_error(const std::string &message, const annotations::Sour
     result.errors.emplace_back(message, file_name, range);
 }
 
+/**
+ * Adds a statement at the top level of the program to the given list.
+ * In streaming mode, the statement is instead handed to the stream, after the header if it's the first one,
+ * and then dropped.
+ */
+void ParseHelper::add_statement(ast::StatementList &list, ast::Statement *statement) {
+    if (!stream) {
+        list.items.add_raw(statement);
+        return;
+    }
+    std::unique_ptr<ast::Statement> owned{ statement };
+    if (!result.errors.empty()) {
+        return;
+    }
+    stream_header();
+    stream->statement(*owned);
+    scanner_context.token_strings.recycle();
+}
+
+/**
+ * Hands the header of the program to the stream, unless this was done already.
+ */
+void ParseHelper::stream_header() {
+    if (!header_streamed) {
+        header_streamed = true;
+        stream->header(*header_version, header_num_qubits);
+    }
+}
+
 } // namespace cqasm::v1x::parser
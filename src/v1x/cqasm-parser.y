@@ -1,11 +1,6 @@
 %{
 #include <stdlib.h>
 #include <string.h>
-
-/*  handy clean-up function */
-void free_string(char *s) {
-    if (s) { free(s); }
-}
 %}
 
 %define api.pure full
@@ -45,7 +40,7 @@ void free_string(char *s) {
      */
     #define ADD_SOURCE_LOCATION(v)                                                                               \
         v->set_annotation(cqasm::annotations::SourceLocation(                                                    \
-            helper.file_name,                                                                                    \
+            helper.shared_file_name,                                                                             \
             { { static_cast<std::uint32_t>(yyloc.first_line), static_cast<std::uint32_t>(yyloc.first_column) },  \
               { static_cast<std::uint32_t>(yyloc.last_line), static_cast<std::uint32_t>(yyloc.last_column) } }   \
         ))
@@ -89,7 +84,7 @@ void free_string(char *s) {
 
 /* YYSTYPE union */
 %union {
-    char           	*str;
+    const char     	*str;
     IntegerLiteral  *ilit;
     FloatLiteral    *flit;
     MatrixLiteral   *mat;
@@ -168,11 +163,11 @@ void free_string(char *s) {
 %type <brk>  Break
 %type <cont> Continue
 %type <stmt> Statement AnnotStatement
-%type <stms> StatementList Statements SubStatements
-%type <vers> Version
+%type <stms> StatementList ProgramStatementList Statements SubStatements
+%type <expr> Qubits
+%type <vers> Version ProgramVersion
 %type <prog> Program
 
-%destructor { free_string($$); } <str>
 %destructor { if($$) { delete($$); } } <ilit>
 %destructor { if($$) { delete($$); } } <flit>
 %destructor { if($$) { delete($$); } } <mat>
@@ -308,11 +303,11 @@ OptNewline      : Newline
                 ;
 
 /* Integer literals. */
-IntegerLiteral  : INT_LITERAL                                                   { NEW($$, IntegerLiteral); $$->value = std::strtol($1, nullptr, 0); std::free($1); }
+IntegerLiteral  : INT_LITERAL                                                   { NEW($$, IntegerLiteral); $$->value = std::strtol($1, nullptr, 0); }
                 ;
 
 /* Floating point literals. */
-FloatLiteral    : FLOAT_LITERAL                                                 { NEW($$, FloatLiteral); $$->value = std::strtod($1, nullptr); std::free($1); }
+FloatLiteral    : FLOAT_LITERAL                                                 { NEW($$, FloatLiteral); $$->value = std::strtod($1, nullptr); }
                 ;
 
 /* Matrix syntax. */
@@ -326,8 +321,8 @@ MatrixLiteral   : '[' OptNewline MatrixRows OptNewline ']'
 
 /* String builder. This accumulates JSON/String data, mostly
 character-by-character. */
-StringBuilder   : StringBuilder STRBUILD_APPEND                                 { FROM($$, $1); $$->push_string(std::string($2)); std::free($2); }
-                | StringBuilder STRBUILD_ESCAPE                                 { FROM($$, $1); $$->push_escape(std::string($2)); std::free($2); }
+StringBuilder   : StringBuilder STRBUILD_APPEND                                 { FROM($$, $1); $$->push_string(std::string($2)); }
+                | StringBuilder STRBUILD_ESCAPE                                 { FROM($$, $1); $$->push_escape(std::string($2)); }
                 |                                                               { NEW($$, StringBuilder); }
                 ;
 
@@ -340,7 +335,7 @@ JsonLiteral     : JSON_OPEN StringBuilder JSON_CLOSE
                 ;
 
 /* Identifiers. */
-Identifier      : IDENTIFIER                                                    { NEW($$, Identifier); $$->name = std::string($1); std::free($1); }
+Identifier      : IDENTIFIER                                                    { NEW($$, Identifier); $$->name = std::string($1); }
                 ;
 
 /* Function calls. */
@@ -653,8 +648,14 @@ StatementList   : StatementList Newline AnnotStatement
                 | AnnotStatement                                                { NEW($$, StatementList); $$->items.add_raw($1); }
                 ;
 
+/* List of one or more statements at the top level of the program, which are streamed if the helper is. */
+ProgramStatementList
+                : ProgramStatementList Newline AnnotStatement                   { FROM($$, $1); helper.add_statement(*$$, $3); }
+                | AnnotStatement                                                { NEW($$, StatementList); helper.add_statement(*$$, $1); }
+                ;
+
 /* List of zero or more statements preceded by a newline. */
-Statements      : Newline StatementList OptNewline                              { FROM($$, $2); }
+Statements      : Newline ProgramStatementList OptNewline                       { FROM($$, $2); }
                 | OptNewline                                                    { NEW($$, StatementList); }
                 ;
 
@@ -663,11 +664,18 @@ Version         : Version '.' IntegerLiteral
                 | IntegerLiteral                                                { NEW($$, Version); $$->items.clear(); $$->items.push_back($1->value); delete $1; }
                 ;
 
+/* Version and qubits statements, which the helper needs before the first statement if it streams them. */
+ProgramVersion  : Version                                                       { $$ = $1; helper.header_version = $$; }
+                ;
+
+Qubits          : QUBITS Expression                                             { $$ = $2; helper.header_num_qubits = $$; }
+                ;
+
 /* Program. */
-Program         : OptNewline VERSION Version Newline
-                    QUBITS Expression
-                    Statements                                                  { NEW($$, Program); $$->version.set_raw($3); $$->num_qubits.set_raw($6); $$->statements.set_raw($7); }
-                | OptNewline VERSION Version
+Program         : OptNewline VERSION ProgramVersion Newline
+                    Qubits
+                    Statements                                                  { NEW($$, Program); $$->version.set_raw($3); $$->num_qubits.set_raw($5); $$->statements.set_raw($6); }
+                | OptNewline VERSION ProgramVersion
                     Statements                                                  { NEW($$, Program); $$->version.set_raw($3); $$->statements.set_raw($4); }
                 ;
 
@@ -2,6 +2,8 @@
  * Implementation for the internal Python-wrapped functions and classes.
  */
 
+#include "cqasm-mapped-file.hpp"
+#include "cqasm-py-result-conversion.hpp"
 #include "cqasm-version.hpp"
 #include "v1x/cqasm-analyzer.hpp"
 #include "v1x/cqasm-parse-helper.hpp"
@@ -13,6 +15,8 @@
 
 namespace v1x = cqasm::v1x;
 
+using cqasm::result::to_py_result;
+
 /**
  * Creates a new v1.x semantic analyzer.
  * When without_defaults is specified,
@@ -73,12 +77,10 @@ void V1xAnalyzer::register_error_model(const std::string &name, const std::strin
  * Only parses the given file.
  * The file must be in v1.x syntax.
  * No version check or conversion is performed.
- * Returns a vector of strings, of which the first is reserved for the CBOR serialization of the v1.x AST.
- * Any additional strings represent error messages.
- * Notice that the AST and error messages won't be available at the same time.
+ * Returns a PyResult with either the CBOR serialization of the v1.x AST, or the error messages.
  */
-std::vector<std::string> V1xAnalyzer::parse_file(const std::string &file_name) {
-    return v1x::parser::parse_file(file_name).to_strings();
+PyResult V1xAnalyzer::parse_file(const std::string &file_name) {
+    return to_py_result(v1x::parser::parse_file(file_name));
 }
 
 /**
@@ -92,9 +94,9 @@ std::string V1xAnalyzer::parse_file_to_json(const std::string &file_name) {
  * Same as parse_file(), but instead receives the file contents directly.
  * The file_name, if specified, is only used when reporting errors.
  */
-std::vector<std::string> V1xAnalyzer::parse_string(const std::string &data, const std::string &file_name) {
+PyResult V1xAnalyzer::parse_string(const std::string &data, const std::string &file_name) {
     auto file_name_op = !file_name.empty() ? std::optional<std::string>{ file_name } : std::nullopt;
-    return v1x::parser::parse_string(data, file_name_op).to_strings();
+    return to_py_result(v1x::parser::parse_string(data, file_name_op));
 }
 
 /**
@@ -110,24 +112,26 @@ std::string V1xAnalyzer::parse_string_to_json(const std::string &data, const std
  * If the file is written in a later file version,
  * this function may try to reduce it to the maximum v1.x API version support advertised
  * using this object's constructor.
- * Returns a vector of strings, of which the first is reserved for the CBOR serialization of the v1.x semantic tree.
- * Any additional strings represent error messages.
- * Notice that the AST and error messages won't be available at the same time.
+ * Returns a PyResult with either the CBOR serialization of the v1.x semantic tree, or the error messages.
  */
-[[nodiscard]] std::vector<std::string> V1xAnalyzer::analyze_file(const std::string &file_name) const {
-    return analyzer->analyze(
-        [=](){ return cqasm::version::parse_file(file_name); },
-        [=](){ return v1x::parser::parse_file(file_name); }
-    ).to_strings();
+[[nodiscard]] PyResult V1xAnalyzer::analyze_file(const std::string &file_name) const {
+    // The file is mapped only once, by the version parser closure, which is always run first
+    std::optional<cqasm::utils::MappedFile> file{};
+    return to_py_result(analyzer->analyze(
+        [&](){ file.emplace(file_name); return cqasm::version::parse_view(file->data(), file_name); },
+        [&](){ return v1x::parser::parse_view(file->data(), file_name); }
+    ));
 }
 
 /**
  * Counterpart of analyze_file that returns a string with a JSON representation of the AnalysisResult.
  */
 [[nodiscard]] std::string V1xAnalyzer::analyze_file_to_json(const std::string &file_name) const {
+    // The file is mapped only once, by the version parser closure, which is always run first
+    std::optional<cqasm::utils::MappedFile> file{};
     return analyzer->analyze(
-        [=](){ return cqasm::version::parse_file(file_name); },
-        [=](){ return v1x::parser::parse_file(file_name); }
+        [&](){ file.emplace(file_name); return cqasm::version::parse_view(file->data(), file_name); },
+        [&](){ return v1x::parser::parse_view(file->data(), file_name); }
     ).to_json();
 }
 
@@ -135,14 +139,14 @@ std::string V1xAnalyzer::parse_string_to_json(const std::string &data, const std
  * Same as analyze_file(), but instead receives the file contents directly.
  * The file_name, if specified, is only used when reporting errors.
  */
-[[nodiscard]] std::vector<std::string> V1xAnalyzer::analyze_string(
+[[nodiscard]] PyResult V1xAnalyzer::analyze_string(
     const std::string &data, const std::string &file_name) const {
 
     auto file_name_op = !file_name.empty() ? std::optional<std::string>{ file_name } : std::nullopt;
-    return analyzer->analyze(
+    return to_py_result(analyzer->analyze(
         [=](){ return cqasm::version::parse_string(data, file_name_op); },
         [=](){ return v1x::parser::parse_string(data, file_name_op); }
-    ).to_strings();
+    ));
 }
 
 /**
@@ -18,6 +18,14 @@ using Value = values::Value;
 using Values = values::Values;
 
 
+/**
+ * Creates an empty table for a scope nested within that of the given parent table.
+ * Only the mappings added to the new table are stored in it,
+ * the parent table is not copied, so it must outlive the new table.
+ */
+MappingTable::MappingTable(const MappingTable *parent)
+: parent{ parent } {}
+
 /**
  * Adds a mapping.
  * For v1, mappings are added and resolved case-insensitively.
@@ -27,37 +35,35 @@ void MappingTable::add(
     const values::Value &value,
     const tree::Maybe<ast::Mapping> &node
 ) {
-    auto lowercase_name = utils::to_lowercase(name);
-    auto it = table.find(lowercase_name);
-    if (it != table.end()) {
+    // The name is stored in lowercase, as it ends up in the semantic tree
+    if (auto it = table.find(name); it != table.end()) {
         table.erase(it);
     }
-    table.insert(
-        std::make_pair(
-            lowercase_name,
-            std::pair<const values::Value, tree::Maybe<ast::Mapping>>(value, node)
-        )
+    table.emplace(
+        utils::to_lowercase(name),
+        std::pair<const values::Value, tree::Maybe<ast::Mapping>>(value, node)
     );
 }
 
 /**
- * Resolves a mapping.
+ * Resolves a mapping, in this table first, and then in the parent tables.
  * For v1, mappings are added and resolved case-insensitively.
  * Throws NameResolutionFailure if no mapping by the given name exists.
  */
 Value MappingTable::resolve(const std::string &name) const {
-    auto entry = table.find(utils::to_lowercase(name));
-    if (entry == table.end()) {
-        throw NameResolutionFailure("failed to resolve " + name);
-    } else {
-        return Value(entry->second.first->clone());
+    for (auto scope_table = this; scope_table; scope_table = scope_table->parent) {
+        if (auto entry = scope_table->table.find(name); entry != scope_table->table.end()) {
+            return Value(entry->second.first->clone());
+        }
     }
+    throw NameResolutionFailure("failed to resolve " + name);
 }
 
 /**
  * Grants read access to the underlying map.
+ * This only contains the mappings added to this table, not those of the parent tables.
  */
-const std::unordered_map<std::string, std::pair<const values::Value, tree::Maybe<ast::Mapping>>> &MappingTable::get_table() const {
+const MappingTable::Table &MappingTable::get_table() const {
     return table;
 }
 
@@ -91,7 +97,7 @@ FunctionTable& FunctionTable::operator=(FunctionTable&& t) noexcept {
  * so adding does have the effect of overriding.
  */
 void FunctionTable::add(const std::string &name, const Types &param_types, const FunctionImpl &impl) {
-    resolver->add_overload(utils::to_lowercase(name), impl, param_types);
+    resolver->add_overload(name, impl, param_types);
 }
 
 /**
@@ -103,7 +109,7 @@ void FunctionTable::add(const std::string &name, const Types &param_types, const
  */
 Value FunctionTable::call(const std::string &name, const Values &args) const {
     // Resolve the function and type-check/promote the argument list.
-    auto resolution = resolver->resolve(utils::to_lowercase(name), args);
+    auto resolution = resolver->resolve(name, args);
 
     // Call the function with the type-checked/promoted argument list, and return its result.
     return resolution.first(resolution.second);
@@ -131,7 +137,7 @@ ErrorModelTable& ErrorModelTable::operator=(ErrorModelTable&& t) noexcept {
  * For v1, overload names are added and resolved case-insensitively.
  */
 void ErrorModelTable::add(const error_model::ErrorModel &type) {
-    resolver->add_overload(utils::to_lowercase(type.name), type, type.param_types);
+    resolver->add_overload(type.name, type, type.param_types);
 }
 
 /**
@@ -173,7 +179,7 @@ InstructionTable& InstructionTable::operator=(InstructionTable&& t) noexcept {
  * For v1, overload names are added and resolved case-insensitively.
  */
 void InstructionTable::add(const instruction::Instruction &type) {
-    resolver->add_overload(utils::to_lowercase(type.name), type, type.param_types);
+    resolver->add_overload(type.name, type, type.param_types);
 }
 
 /**
@@ -188,7 +194,7 @@ tree::One<semantic::Instruction> InstructionTable::resolve(
     const std::string &name,
     const Values &args
 ) const {
-    auto resolved = resolver->resolve(utils::to_lowercase(name), args);
+    auto resolved = resolver->resolve(name, args);
     return tree::make<semantic::Instruction>(
         tree::make<instruction::Instruction>(resolved.first),
         utils::to_lowercase(name),
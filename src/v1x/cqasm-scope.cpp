@@ -5,16 +5,29 @@ namespace cqasm::v1x::analyzer {
 
 /**
  * Creates a scope from a table of mappings, functions, and an instruction set.
+ * The function table and the instruction set are not copied, so they must outlive the scope.
  */
 Scope::Scope(
     resolver::MappingTable mappings,
-    resolver::FunctionTable functions,
-    resolver::InstructionTable instruction_set)
+    const resolver::FunctionTable &functions,
+    const resolver::InstructionTable &instruction_set)
 : mappings{ std::move(mappings) }
-, functions{ std::move(functions) }
-, instruction_set{ std::move(instruction_set) }
+, functions{ functions }
+, instruction_set{ instruction_set }
 , block{}
 , within_loop{ false }
 {}
 
+/**
+ * Creates the scope of a block nested within the given parent scope.
+ * Nothing is copied from the parent scope, which must outlive the new scope.
+ */
+Scope::Scope(const Scope &parent, tree::Maybe<semantic::Block> block, bool is_loop)
+: mappings{ &parent.mappings }
+, functions{ parent.functions }
+, instruction_set{ parent.instruction_set }
+, block{ std::move(block) }
+, within_loop{ parent.within_loop || is_loop }
+{}
+
 } // namespace cqasm::v1x::analyzer
@@ -9,6 +9,7 @@
 #include "v1x/cqasm-semantic.hpp"
 
 #include <fmt/format.h>
+#include <numeric>  // accumulate
 
 
 namespace cqasm::v1x::values {
@@ -96,6 +97,26 @@ Value promote(const Value &value, const types::Type &type) {
     return retval;
 }
 
+/**
+ * Returns a key identifying the given value as far as promotion is concerned:
+ * values with the same key can be promoted to exactly the same types.
+ * Used to memoize overload resolutions.
+ *
+ * Promotion depends on the kind of value (e.g. a constant or a reference),
+ * on the kind of its type, on its assignability, and on the dimensions of matrix types.
+ */
+cqasm::overload::PromotionKey promotion_key(const Value &value) {
+    const auto &type = type_of(value);
+    auto ret = cqasm::overload::PromotionKey{
+        static_cast<int>(value->type()), static_cast<int>(type->type()), type->assignable };
+    if (const auto &real_matrix = type->as_real_matrix()) {
+        ret.dims = { static_cast<std::size_t>(real_matrix->num_rows), static_cast<std::size_t>(real_matrix->num_cols) };
+    } else if (const auto &complex_matrix = type->as_complex_matrix()) {
+        ret.dims = { static_cast<std::size_t>(complex_matrix->num_rows), static_cast<std::size_t>(complex_matrix->num_cols) };
+    }
+    return ret;
+}
+
 /**
  * Returns the type of the given value.
  */
@@ -168,6 +189,30 @@ void check_const(const Values &values) {
     }
 }
 
+/**
+ * Returns the number of indices in the given index ranges.
+ */
+primitives::Int size_of(const tree::Many<IndexRange> &indices) {
+    return std::accumulate(indices.begin(), indices.end(), primitives::Int{ 0 },
+        [](primitives::Int acc, const auto &range) { return acc + range->last - range->first + 1; });
+}
+
+/**
+ * Returns the individual indices in the given index ranges, in order. Index
+ * ranges are only expanded on demand, by the consumers that need every single
+ * index.
+ */
+std::vector<primitives::Int> expand_indices(const tree::Many<IndexRange> &indices) {
+    std::vector<primitives::Int> ret{};
+    ret.reserve(static_cast<std::size_t>(size_of(indices)));
+    for (const auto &range : indices) {
+        for (auto index = range->first; index <= range->last; ++index) {
+            ret.push_back(index);
+        }
+    }
+    return ret;
+}
+
 /**
  * Stream << overload for a single value.
  */
@@ -13,7 +13,11 @@ namespace cqasm::v3x::analyzer {
 AnalyzeTreeGenAstVisitor::AnalyzeTreeGenAstVisitor(Analyzer &analyzer)
 : analyzer_{ analyzer }
 , result_{}
-{}
+, constant_folder_{} {
+    if (analyzer_.config_->folds_constants()) {
+        constant_folder_.emplace(analyzer_);
+    }
+}
 
 std::any AnalyzeTreeGenAstVisitor::visit_node(ast::Node &/* node */) {
     throw error::AnalysisError{ "unimplemented" };
@@ -113,11 +117,8 @@ std::any AnalyzeTreeGenAstVisitor::visit_variable(ast::Variable &node) {
         ret->annotations = std::any_cast<tree::Any<semantic::AnnotationData>>(visit_annotated(*node.as_annotated()));
         ret->copy_annotation<parser::SourceLocation>(*identifier);
 
-        // Add the variable to the current scope
+        // Add the variable to the current scope, and register it
         analyzer_.add_variable_to_current_scope(ret);
-
-        // Register the variable
-        analyzer_.register_variable(identifier->name, tree::make<values::VariableRef>(ret));
     } catch (error::AnalysisError &err) {
         err.context(node);
         result_.errors.push_back(std::move(err));
@@ -370,9 +371,9 @@ bool check_qubit_and_bit_indices_have_same_size(const values::Values &operands)
         } else if (auto index_ref = operand->as_index_ref()) {
             const auto &variable = *index_ref->variable;
             if (variable.typ->as_qubit() || variable.typ->as_qubit_array()) {
-                qubit_indices_size += index_ref->indices.size();
+                qubit_indices_size += values::size_of(index_ref->indices);
             } else if (variable.typ->as_bit() || variable.typ->as_bit_array()) {
-                bit_indices_size += index_ref->indices.size();
+                bit_indices_size += values::size_of(index_ref->indices);
             }
         }
     }
@@ -445,7 +446,10 @@ std::any AnalyzeTreeGenAstVisitor::visit_measure_instruction(ast::MeasureInstruc
 
 std::any AnalyzeTreeGenAstVisitor::visit_expression(ast::Expression &node) {
     try {
-        auto ret = std::any_cast<values::Value>(node.visit(*this));
+        auto ret = constant_folder_ ? constant_folder_->fold(node) : values::Value{};
+        if (ret.empty()) {
+            ret = std::any_cast<values::Value>(node.visit(*this));
+        }
         ret->copy_annotation<parser::SourceLocation>(node);
         return ret;
     } catch (error::AnalysisError &err) {
@@ -612,16 +616,22 @@ std::any AnalyzeTreeGenAstVisitor::visit_ternary_conditional_expression(ast::Ter
  * Check out of range accesses from any index in an input list to an array of a given size
  */
 void check_out_of_range(const IndexListT &indices, primitives::Int size) {
-    for (const auto &index_item : indices) {
-        if (index_item->value < 0 || index_item->value >= size) {
-            throw error::AnalysisError{ fmt::format("index {} out of range (size {})", index_item->value, size) };
+    for (const auto &index_range : indices) {
+        // Report the first index out of range
+        if (index_range->first < 0 || index_range->first >= size) {
+            throw error::AnalysisError{ fmt::format("index {} out of range (size {})", index_range->first, size) };
+        } else if (index_range->last >= size) {
+            throw error::AnalysisError{ fmt::format("index {} out of range (size {})", size, size) };
         }
     }
 }
 
 std::any AnalyzeTreeGenAstVisitor::visit_index(ast::Index &node) {
     try {
-        auto expression = std::any_cast<values::Value>(visit_expression(*node.expr));
+        // The indexed variable is only read, so its value does not need to be copied out of the variable table
+        const auto expression = node.expr->as_identifier()
+            ? resolve_identifier(*node.expr->as_identifier())
+            : std::any_cast<values::Value>(visit_expression(*node.expr));
         auto variable_ref_ptr = expression->as_variable_ref();
         const auto variable_link = variable_ref_ptr->variable;
         const auto variable_type = variable_link->typ;
@@ -648,7 +658,7 @@ std::any AnalyzeTreeGenAstVisitor::visit_index_list(ast::IndexList &index_list_a
             ret.add(std::any_cast<tree::One<IndexT>>(visit_index_item(*index_item)));
         } else if (auto index_range = index_entry->as_index_range()) {
             // Range notation
-            ret.extend(std::any_cast<IndexListT>(visit_index_range(*index_range)));
+            ret.add(std::any_cast<tree::One<IndexT>>(visit_index_range(*index_range)));
         } else {
             throw std::runtime_error{ "unknown IndexEntry AST node" };
         }
@@ -657,10 +667,10 @@ std::any AnalyzeTreeGenAstVisitor::visit_index_list(ast::IndexList &index_list_a
 }
 
 std::any AnalyzeTreeGenAstVisitor::visit_index_item(ast::IndexItem &index_item_ast) {
-    auto index_item = visit_const_int(*index_item_ast.index);
-    auto index_value_sp = tree::make<IndexT>(index_item);
-    index_value_sp->copy_annotation<parser::SourceLocation>(index_item_ast);
-    return index_value_sp;
+    auto index = visit_const_int(*index_item_ast.index);
+    auto index_range_sp = tree::make<IndexT>(index, index);
+    index_range_sp->copy_annotation<parser::SourceLocation>(index_item_ast);
+    return index_range_sp;
 }
 
 std::any AnalyzeTreeGenAstVisitor::visit_index_range(ast::IndexRange &index_range_ast) {
@@ -669,17 +679,28 @@ std::any AnalyzeTreeGenAstVisitor::visit_index_range(ast::IndexRange &index_rang
     if (first > last) {
         throw error::AnalysisError("last index is lower than first index", &index_range_ast);
     }
-    IndexListT ret{};
-    for (auto index = first; index <= last; index++) {
-        auto index_value_sp = tree::make<IndexT>(index);
-        index_value_sp->copy_annotation<parser::SourceLocation>(index_range_ast);
-        ret.add(index_value_sp);
+    auto index_range_sp = tree::make<IndexT>(first, last);
+    index_range_sp->copy_annotation<parser::SourceLocation>(index_range_ast);
+    return index_range_sp;
+}
+
+/**
+ * Resolves an identifier to the value shared with the variable tables,
+ * which must thus not be modified nor added to the tree
+ */
+values::Value AnalyzeTreeGenAstVisitor::resolve_identifier(ast::Identifier &node) const {
+    try {
+        return analyzer_.resolve_variable(node.name);
+    } catch (error::AnalysisError &err) {
+        err.context(node);
+        throw;
     }
-    return ret;
 }
 
 std::any AnalyzeTreeGenAstVisitor::visit_identifier(ast::Identifier &node) {
-    return analyzer_.resolve_variable(node.name);
+    // Copy on write: the value is going to be annotated and added to the tree
+    values::Value ret = analyzer_.resolve_variable(node.name)->clone();
+    return ret;
 }
 
 /**
@@ -691,11 +712,11 @@ std::any AnalyzeTreeGenAstVisitor::visit_identifier(ast::Identifier &node) {
 /* static */ values::Value AnalyzeTreeGenAstVisitor::build_value_from_promoted_values(
     const values::Values &values, const types::Type &type) {
 
-    if (types::type_check(type, tree::make<types::Bool>())) {
+    if (types::type_check(type, types::interned<types::Bool>())) {
         return build_array_value_from_promoted_values<values::ConstBoolArray>(values, type);
-    } else if (types::type_check(type, tree::make<types::Int>())) {
+    } else if (types::type_check(type, types::interned<types::Int>())) {
         return build_array_value_from_promoted_values<values::ConstIntArray>(values, type);
-    } else if (types::type_check(type, tree::make<types::Float>())) {
+    } else if (types::type_check(type, types::interned<types::Float>())) {
         return build_array_value_from_promoted_values<values::ConstFloatArray>(values, type);
     } else {
         throw error::AnalysisError{ "expecting Bool, Int, or Float type in initialization list" };
@@ -20,10 +20,9 @@ using namespace cqasm::v3x::ast;
 using namespace cqasm::error;
 
 BuildTreeGenAstVisitor::BuildTreeGenAstVisitor(const std::optional<std::string> &file_name)
-: file_name_{ file_name }
-, error_listener_p_{ nullptr } {
-    if (file_name_.has_value() && file_name_.value().empty()) {
-        file_name_ = std::nullopt;
+: error_listener_p_{ nullptr } {
+    if (file_name.has_value() && !file_name.value().empty()) {
+        file_name_ = annotations::FileName{ file_name.value() };
     }
 }
 
@@ -0,0 +1,335 @@
+#include "cqasm-error.hpp"
+#include "v3x/ConstantFolder.hpp"
+#include "v3x/cqasm-analyzer.hpp"
+#include "v3x/cqasm-functions.hpp"
+
+#include <functional>  // negate, plus, minus...
+#include <tuple>  // apply, make_tuple
+#include <type_traits>  // is_same_v
+#include <unordered_map>
+#include <unordered_set>
+
+
+namespace cqasm::v3x::analyzer {
+
+namespace {
+
+using Constant = ConstantFolder::Constant;
+
+/**
+ * An overload of a default function implementation: the type of its parameters, and its return type.
+ */
+template <typename ParamType, typename ReturnType = ParamType>
+struct Overload {
+    using param_type = ParamType;
+    using return_type = ReturnType;
+};
+
+/**
+ * Promotes a constant to the given primitive type, following the promotion rules for constant values:
+ * booleans promote to integers and floats, and integers to floats.
+ */
+template <typename T>
+std::optional<T> promote(const Constant &constant) {
+    return std::visit([](auto value) -> std::optional<T> {
+        using From = decltype(value);
+        if constexpr (std::is_same_v<From, T>) {
+            return value;
+        } else if constexpr (std::is_same_v<T, primitives::Int> && std::is_same_v<From, primitives::Bool>) {
+            return static_cast<primitives::Int>(value);
+        } else if constexpr (std::is_same_v<T, primitives::Float>) {
+            return static_cast<primitives::Float>(value);
+        } else {
+            return std::nullopt;
+        }
+    }, constant);
+}
+
+/**
+ * Calls f if all the arguments can be promoted to the parameter type of the given overload.
+ * Returns whether it did.
+ */
+template <typename Overload, typename Function, typename... Args>
+bool try_overload(std::optional<Constant> &ret, Function f, const Args &...args) {
+    const auto promoted_args = std::make_tuple(promote<typename Overload::param_type>(args)...);
+    if (!std::apply([](const auto &...promoted) { return (promoted.has_value() && ...); }, promoted_args)) {
+        return false;
+    }
+    ret.emplace(std::in_place_type<typename Overload::return_type>,
+        std::apply([&f](const auto &...promoted) { return f(*promoted...); }, promoted_args));
+    return true;
+}
+
+/**
+ * Calls f with the arguments promoted to the first of the overloads they can be promoted to,
+ * or returns nullopt if there is none.
+ * The overloads must be given in the order overload resolution tries them,
+ * i.e. the reverse of the order register_default_function_impls_into registers them.
+ */
+template <typename... Overloads, typename Function, typename... Args>
+std::optional<Constant> call(Function f, const Args &...args) {
+    std::optional<Constant> ret{};
+    (try_overload<Overloads>(ret, f, args...) || ...);
+    return ret;
+}
+
+using B = Overload<primitives::Bool>;
+using I = Overload<primitives::Int>;
+using F = Overload<primitives::Float>;
+using BToB = Overload<primitives::Bool, primitives::Bool>;
+using IToB = Overload<primitives::Int, primitives::Bool>;
+using FToB = Overload<primitives::Float, primitives::Bool>;
+
+/**
+ * Folds a call to a default function, given its folded argument.
+ */
+using FoldFunction = std::optional<Constant> (*)(const Constant &);
+
+const std::unordered_map<std::string, FoldFunction> &fold_functions() {
+    static const std::unordered_map<std::string, FoldFunction> fold_functions{
+        { "sqrt", [](const Constant &arg) { return call<F>(functions::sqrt, arg); } },
+        { "exp", [](const Constant &arg) { return call<F>(functions::exp, arg); } },
+        { "log", [](const Constant &arg) { return call<F>(functions::log, arg); } },
+        { "sin", [](const Constant &arg) { return call<F>(functions::sin, arg); } },
+        { "cos", [](const Constant &arg) { return call<F>(functions::cos, arg); } },
+        { "tan", [](const Constant &arg) { return call<F>(functions::tan, arg); } },
+        { "sinh", [](const Constant &arg) { return call<F>(functions::sinh, arg); } },
+        { "cosh", [](const Constant &arg) { return call<F>(functions::cosh, arg); } },
+        { "tanh", [](const Constant &arg) { return call<F>(functions::tanh, arg); } },
+        { "asin", [](const Constant &arg) { return call<F>(functions::asin, arg); } },
+        { "acos", [](const Constant &arg) { return call<F>(functions::acos, arg); } },
+        { "atan", [](const Constant &arg) { return call<F>(functions::atan, arg); } },
+        { "asinh", [](const Constant &arg) { return call<F>(functions::asinh, arg); } },
+        { "acosh", [](const Constant &arg) { return call<F>(functions::acosh, arg); } },
+        { "atanh", [](const Constant &arg) { return call<F>(functions::atanh, arg); } },
+        { "abs", [](const Constant &arg) { return call<I, F>(functions::abs, arg); } },
+    };
+    return fold_functions;
+}
+
+}  // namespace
+
+ConstantFolder::ConstantFolder(const Analyzer &analyzer)
+: analyzer_{ analyzer } {}
+
+/**
+ * Returns whether the given function, or operator, e.g. "operator+", is one that can be folded.
+ */
+/* static */ bool ConstantFolder::folds(const std::string &function_name) {
+    static const std::unordered_set<std::string> operator_names{
+        "operator-", "operator~", "operator!",
+        "operator**", "operator*", "operator/", "operator%", "operator+",
+        "operator<<", "operator>>",
+        "operator>", "operator<", "operator>=", "operator<=", "operator==", "operator!=",
+        "operator&", "operator^", "operator|",
+        "operator&&", "operator^^", "operator||",
+        "operator?:"
+    };
+    return operator_names.contains(function_name) || fold_functions().contains(function_name);
+}
+
+/**
+ * Returns the constant value of an operator or function call expression,
+ * or an empty value if it cannot be folded.
+ * Literals and identifiers are not folded, as they are already single value nodes.
+ */
+values::Value ConstantFolder::fold(ast::Expression &expression) {
+    if (!expression.as_unary_expression() && !expression.as_binary_expression() &&
+        !expression.as_ternary_conditional_expression() && !expression.as_function_call()) {
+        return {};
+    }
+    const auto constant = fold_operand(expression);
+    if (!constant.has_value()) {
+        return {};
+    }
+    return std::visit([](auto value) -> values::Value {
+        using T = decltype(value);
+        if constexpr (std::is_same_v<T, primitives::Bool>) {
+            return tree::make<values::ConstBool>(value);
+        } else if constexpr (std::is_same_v<T, primitives::Int>) {
+            return tree::make<values::ConstInt>(value);
+        } else {
+            return tree::make<values::ConstFloat>(value);
+        }
+    }, *constant);
+}
+
+std::optional<Constant> ConstantFolder::fold_operand(ast::Expression &expression) {
+    if (not_constant_.contains(&expression)) {
+        return std::nullopt;
+    }
+    auto ret = expression.visit(*this);
+    if (!ret.has_value()) {
+        not_constant_.insert(&expression);
+    }
+    return ret;
+}
+
+std::optional<Constant> ConstantFolder::visit_node(ast::Node &/* node */) {
+    return std::nullopt;
+}
+
+std::optional<Constant> ConstantFolder::visit_boolean_literal(ast::BooleanLiteral &node) {
+    return Constant{ std::in_place_type<primitives::Bool>, node.value };
+}
+
+std::optional<Constant> ConstantFolder::visit_integer_literal(ast::IntegerLiteral &node) {
+    return Constant{ std::in_place_type<primitives::Int>, node.value };
+}
+
+std::optional<Constant> ConstantFolder::visit_float_literal(ast::FloatLiteral &node) {
+    return Constant{ std::in_place_type<primitives::Float>, node.value };
+}
+
+std::optional<Constant> ConstantFolder::visit_identifier(ast::Identifier &node) {
+    values::Value value{};
+    try {
+        value = analyzer_.resolve_variable(node.name);
+    } catch (const error::AnalysisError &) {
+        return std::nullopt;
+    }
+    if (const auto *const_bool = value->as_const_bool()) {
+        return Constant{ std::in_place_type<primitives::Bool>, const_bool->value };
+    } else if (const auto *const_int = value->as_const_int()) {
+        return Constant{ std::in_place_type<primitives::Int>, const_int->value };
+    } else if (const auto *const_float = value->as_const_float()) {
+        return Constant{ std::in_place_type<primitives::Float>, const_float->value };
+    }
+    return std::nullopt;
+}
+
+std::optional<Constant> ConstantFolder::visit_function_call(ast::FunctionCall &node) {
+    const auto &functions = fold_functions();
+    const auto entry = functions.find(node.name->name);
+    if (entry == functions.end() || node.arguments.empty() || node.arguments->items.size() != 1) {
+        return std::nullopt;
+    }
+    if (const auto arg = fold_operand(*node.arguments->items[0])) {
+        return entry->second(*arg);
+    }
+    return std::nullopt;
+}
+
+std::optional<Constant> ConstantFolder::visit_unary_minus_expression(ast::UnaryMinusExpression &node) {
+    const auto arg = fold_operand(*node.expr);
+    return arg ? call<I, F>(std::negate{}, *arg) : std::nullopt;
+}
+
+std::optional<Constant> ConstantFolder::visit_bitwise_not_expression(ast::BitwiseNotExpression &node) {
+    const auto arg = fold_operand(*node.expr);
+    return arg ? call<I>(std::bit_not{}, *arg) : std::nullopt;
+}
+
+std::optional<Constant> ConstantFolder::visit_logical_not_expression(ast::LogicalNotExpression &node) {
+    const auto arg = fold_operand(*node.expr);
+    return arg ? call<B>(std::logical_not{}, *arg) : std::nullopt;
+}
+
+/**
+ * Folds a binary operator, given its overloads in the order overload resolution tries them.
+ */
+template <typename... Overloads, typename Function>
+std::optional<Constant> ConstantFolder::fold_binary(ast::BinaryExpression &node, Function f) {
+    const auto lhs = fold_operand(*node.lhs);
+    const auto rhs = lhs ? fold_operand(*node.rhs) : std::nullopt;
+    return lhs && rhs ? call<Overloads...>(f, *lhs, *rhs) : std::nullopt;
+}
+
+std::optional<Constant> ConstantFolder::visit_power_expression(ast::PowerExpression &node) {
+    return fold_binary<F>(node, functions::pow);
+}
+
+std::optional<Constant> ConstantFolder::visit_product_expression(ast::ProductExpression &node) {
+    return fold_binary<I, F>(node, std::multiplies{});
+}
+
+std::optional<Constant> ConstantFolder::visit_division_expression(ast::DivisionExpression &node) {
+    return fold_binary<I, F>(node, std::divides{});
+}
+
+std::optional<Constant> ConstantFolder::visit_modulo_expression(ast::ModuloExpression &node) {
+    return fold_binary<I>(node, std::modulus{});
+}
+
+std::optional<Constant> ConstantFolder::visit_addition_expression(ast::AdditionExpression &node) {
+    return fold_binary<I, F>(node, std::plus{});
+}
+
+std::optional<Constant> ConstantFolder::visit_subtraction_expression(ast::SubtractionExpression &node) {
+    return fold_binary<I, F>(node, std::minus{});
+}
+
+std::optional<Constant> ConstantFolder::visit_shift_left_expression(ast::ShiftLeftExpression &node) {
+    return fold_binary<I>(node, functions::shl);
+}
+
+std::optional<Constant> ConstantFolder::visit_shift_right_expression(ast::ShiftRightExpression &node) {
+    return fold_binary<I>(node, functions::shr);
+}
+
+std::optional<Constant> ConstantFolder::visit_cmp_gt_expression(ast::CmpGtExpression &node) {
+    return fold_binary<BToB, IToB, FToB>(node, std::greater{});
+}
+
+std::optional<Constant> ConstantFolder::visit_cmp_lt_expression(ast::CmpLtExpression &node) {
+    return fold_binary<BToB, IToB, FToB>(node, std::less{});
+}
+
+std::optional<Constant> ConstantFolder::visit_cmp_ge_expression(ast::CmpGeExpression &node) {
+    return fold_binary<BToB, IToB, FToB>(node, std::greater_equal{});
+}
+
+std::optional<Constant> ConstantFolder::visit_cmp_le_expression(ast::CmpLeExpression &node) {
+    return fold_binary<BToB, IToB, FToB>(node, std::less_equal{});
+}
+
+std::optional<Constant> ConstantFolder::visit_cmp_eq_expression(ast::CmpEqExpression &node) {
+    return fold_binary<BToB, IToB, FToB>(node, std::equal_to{});
+}
+
+std::optional<Constant> ConstantFolder::visit_cmp_ne_expression(ast::CmpNeExpression &node) {
+    return fold_binary<BToB, IToB, FToB>(node, std::not_equal_to{});
+}
+
+std::optional<Constant> ConstantFolder::visit_bitwise_and_expression(ast::BitwiseAndExpression &node) {
+    return fold_binary<I>(node, std::bit_and{});
+}
+
+std::optional<Constant> ConstantFolder::visit_bitwise_xor_expression(ast::BitwiseXorExpression &node) {
+    return fold_binary<I>(node, std::bit_xor{});
+}
+
+std::optional<Constant> ConstantFolder::visit_bitwise_or_expression(ast::BitwiseOrExpression &node) {
+    return fold_binary<I>(node, std::bit_or{});
+}
+
+std::optional<Constant> ConstantFolder::visit_logical_and_expression(ast::LogicalAndExpression &node) {
+    return fold_binary<B>(node, std::logical_and{});
+}
+
+std::optional<Constant> ConstantFolder::visit_logical_xor_expression(ast::LogicalXorExpression &node) {
+    return fold_binary<B>(node, functions::lxor);
+}
+
+std::optional<Constant> ConstantFolder::visit_logical_or_expression(ast::LogicalOrExpression &node) {
+    return fold_binary<B>(node, std::logical_or{});
+}
+
+std::optional<Constant> ConstantFolder::visit_ternary_conditional_expression(
+    ast::TernaryConditionalExpression &node) {
+
+    const auto cond = fold_operand(*node.cond);
+    const auto if_true = cond ? fold_operand(*node.if_true) : std::nullopt;
+    const auto if_false = if_true ? fold_operand(*node.if_false) : std::nullopt;
+    if (!if_false) {
+        return std::nullopt;
+    }
+    const auto condition = promote<primitives::Bool>(*cond);
+    if (!condition) {
+        return std::nullopt;
+    }
+    return call<B, I, F>([condition = *condition](auto a, auto b) { return functions::tcnd(condition, a, b); },
+        *if_true, *if_false);
+}
+
+}  // namespace cqasm::v3x::analyzer
@@ -1,3 +1,4 @@
+#include "cqasm-mapped-file.hpp"
 #include "v3x/cqasm-ast.hpp"
 #include "v3x/cqasm-parse-result.hpp"
 #include "v3x/BuildTreeGenAstVisitor.hpp"
@@ -5,26 +6,98 @@
 #include "v3x/CqasmParser.h"
 #include "v3x/CustomErrorListener.hpp"
 #include "v3x/ScannerAntlr.hpp"
+#include "v3x/StringViewInputStream.hpp"
 
 #include <antlr4-runtime.h>
+#include <atomic>
 #include <filesystem>
 #include <fmt/format.h>
+#include <memory>  // make_shared
+#include <mutex>  // try_to_lock, unique_lock
+#include <numeric>  // accumulate
+#include <shared_mutex>
 
 namespace fs = std::filesystem;
 
 
 namespace cqasm::v3x::parser {
 
+namespace {
+
+/**
+ * Guards the DFA caches, which are static members of the generated lexer and parser.
+ * Parses share the lock, while clearing the caches requires exclusive access.
+ */
+std::shared_mutex dfa_cache_mutex;
+
+/**
+ * Maximum number of states in the DFA cache of the parser, 0 meaning no limit.
+ */
+std::atomic<std::size_t> dfa_cache_limit{ 0 };
+
+/**
+ * Calls f with the lexer and parser ATN simulators, which give access to the DFA caches.
+ * The caller must hold dfa_cache_mutex.
+ */
+template <typename F>
+auto with_atn_simulators(F &&f) {
+    antlr4::ANTLRInputStream is{};
+    CqasmLexer lexer{ &is };
+    antlr4::CommonTokenStream tokens{ &lexer };
+    CqasmParser parser{ &tokens };
+    return f(*lexer.getInterpreter<antlr4::atn::LexerATNSimulator>(),
+        *parser.getInterpreter<antlr4::atn::ParserATNSimulator>());
+}
+
+std::size_t dfa_cache_size_unlocked() {
+    return with_atn_simulators([](auto &, antlr4::atn::ParserATNSimulator &parser_simulator) {
+        const auto &dfas = parser_simulator.decisionToDFA;
+        return std::accumulate(dfas.begin(), dfas.end(), std::size_t{ 0 },
+            [](std::size_t total, const antlr4::dfa::DFA &dfa) { return total + dfa.states.size(); });
+    });
+}
+
+void clear_dfa_cache_unlocked() {
+    with_atn_simulators([](antlr4::atn::LexerATNSimulator &lexer_simulator,
+        antlr4::atn::ParserATNSimulator &parser_simulator) {
+        lexer_simulator.clearDFA();
+        parser_simulator.clearDFA();
+    });
+}
+
+/**
+ * Clears the DFA caches if they have grown beyond dfa_cache_limit.
+ * The check is skipped if other parses are in progress, instead of waiting for them to finish.
+ */
+void enforce_dfa_cache_limit() {
+    auto limit = dfa_cache_limit.load();
+    if (limit == 0) {
+        return;
+    }
+    if (std::unique_lock lock{ dfa_cache_mutex, std::try_to_lock }; lock.owns_lock()) {
+        if (dfa_cache_size_unlocked() > limit) {
+            clear_dfa_cache_unlocked();
+        }
+    }
+}
+
+}  // namespace
+
 ScannerAdaptor::~ScannerAdaptor() {}
 
 ScannerAntlr::ScannerAntlr(std::unique_ptr<BuildCustomAstVisitor> build_visitor_up,
-    std::unique_ptr<CustomErrorListener> error_listener_up)
+    std::unique_ptr<CustomErrorListener> error_listener_up,
+    PredictionMode prediction_mode)
 : build_visitor_up_{ std::move(build_visitor_up) }
-, error_listener_up_{ std::move(error_listener_up) } {}
+, error_listener_up_{ std::move(error_listener_up) }
+, prediction_mode_{ prediction_mode } {}
 
 ScannerAntlr::~ScannerAntlr() {}
 
-cqasm::v3x::parser::ParseResult ScannerAntlr::parse_(antlr4::ANTLRInputStream &is) {
+cqasm::v3x::parser::ParseResult ScannerAntlr::parse_(antlr4::CharStream &is) {
+    enforce_dfa_cache_limit();
+    std::shared_lock dfa_cache_lock{ dfa_cache_mutex };
+
     CqasmLexer lexer{ &is };
     lexer.removeErrorListeners();
     lexer.addErrorListener(error_listener_up_.get());
@@ -32,8 +105,26 @@ cqasm::v3x::parser::ParseResult ScannerAntlr::parse_(antlr4::ANTLRInputStream &i
 
     CqasmParser parser{ &tokens };
     parser.removeErrorListeners();
-    parser.addErrorListener(error_listener_up_.get());
-    auto ast = parser.program();
+    CqasmParser::ProgramContext *ast = nullptr;
+    if (prediction_mode_ == PredictionMode::sll_first) {
+        // First stage: SLL prediction, giving up at the first syntax error, without reporting it
+        parser.getInterpreter<antlr4::atn::ParserATNSimulator>()->setPredictionMode(antlr4::atn::PredictionMode::SLL);
+        parser.setErrorHandler(std::make_shared<antlr4::BailErrorStrategy>());
+        try {
+            ast = parser.program();
+        } catch (const antlr4::ParseCancellationException &) {
+            // Either the input is incorrect, or SLL prediction was not powerful enough
+            // Rewind the token stream, so that the second stage does not need to scan the input again
+            parser.setErrorHandler(std::make_shared<antlr4::DefaultErrorStrategy>());
+            parser.reset();
+        }
+    }
+    if (!ast) {
+        // Second stage, or only stage: full LL prediction, reporting syntax errors
+        parser.getInterpreter<antlr4::atn::ParserATNSimulator>()->setPredictionMode(antlr4::atn::PredictionMode::LL);
+        parser.addErrorListener(error_listener_up_.get());
+        ast = parser.program();
+    }
 
     build_visitor_up_->addErrorListener(error_listener_up_.get());
     auto custom_ast = build_visitor_up_->visitProgram(ast);
@@ -43,10 +134,36 @@ cqasm::v3x::parser::ParseResult ScannerAntlr::parse_(antlr4::ANTLRInputStream &i
     };
 }
 
+std::size_t ScannerAntlr::dfa_cache_size() {
+    std::unique_lock lock{ dfa_cache_mutex };
+    return dfa_cache_size_unlocked();
+}
+
+void ScannerAntlr::clear_dfa_cache() {
+    std::unique_lock lock{ dfa_cache_mutex };
+    clear_dfa_cache_unlocked();
+}
+
+void ScannerAntlr::set_dfa_cache_limit(std::size_t max_states) {
+    dfa_cache_limit = max_states;
+}
+
+cqasm::v3x::parser::ParseResult ScannerAntlr::parse_view_(std::string_view data) {
+    // ANTLRInputStream decodes the whole input into UTF-32, i.e. four bytes per character
+    // cQASM tokens are ASCII, so this is only needed when, e.g., comments contain UTF-8 characters
+    if (StringViewInputStream::is_ascii(data)) {
+        StringViewInputStream is{ data };
+        return parse_(is);
+    }
+    antlr4::ANTLRInputStream is{ data };
+    return parse_(is);
+}
+
 ScannerAntlrFile::ScannerAntlrFile(std::unique_ptr<BuildCustomAstVisitor> build_visitor_up,
     std::unique_ptr<CustomErrorListener> error_listener_up,
-    const std::string &file_path)
-: ScannerAntlr{ std::move(build_visitor_up) , std::move(error_listener_up) }
+    const std::string &file_path,
+    PredictionMode prediction_mode)
+: ScannerAntlr{ std::move(build_visitor_up) , std::move(error_listener_up), prediction_mode }
 , file_path_{ file_path } {
     if (!fs::exists(file_path_) || !fs::is_regular_file(file_path_)) {
         throw cqasm::error::ParseError{ fmt::format("ScannerAntlrFile couldn't access file '{}'.", file_path_) };
@@ -56,22 +173,34 @@ ScannerAntlrFile::ScannerAntlrFile(std::unique_ptr<BuildCustomAstVisitor> build_
 ScannerAntlrFile::~ScannerAntlrFile() {}
 
 cqasm::v3x::parser::ParseResult ScannerAntlrFile::parse() {
-    antlr4::ANTLRFileStream ifs{};
-    ifs.loadFromFile(file_path_);
-    return parse_(ifs);
+    utils::MappedFile file{ file_path_ };
+    return parse_view_(file.data());
 }
 
 ScannerAntlrString::ScannerAntlrString(std::unique_ptr<BuildCustomAstVisitor> build_visitor_up,
     std::unique_ptr<CustomErrorListener> error_listener_up,
-    const std::string &data)
-: ScannerAntlr{ std::move(build_visitor_up), std::move(error_listener_up) }
+    const std::string &data,
+    PredictionMode prediction_mode)
+: ScannerAntlr{ std::move(build_visitor_up), std::move(error_listener_up), prediction_mode }
 , data_{ data } {}
 
 ScannerAntlrString::~ScannerAntlrString() {}
 
 cqasm::v3x::parser::ParseResult ScannerAntlrString::parse() {
-    antlr4::ANTLRInputStream is{ data_ };
-    return parse_(is);
+    return parse_view_(data_);
+}
+
+ScannerAntlrView::ScannerAntlrView(std::unique_ptr<BuildCustomAstVisitor> build_visitor_up,
+    std::unique_ptr<CustomErrorListener> error_listener_up,
+    std::string_view data,
+    PredictionMode prediction_mode)
+: ScannerAntlr{ std::move(build_visitor_up), std::move(error_listener_up), prediction_mode }
+, data_{ data } {}
+
+ScannerAntlrView::~ScannerAntlrView() {}
+
+cqasm::v3x::parser::ParseResult ScannerAntlrView::parse() {
+    return parse_view_(data_);
 }
 
 }  // namespace cqasm::v3x::parser
@@ -0,0 +1,78 @@
+#include "v3x/StringViewInputStream.hpp"
+
+#include <algorithm>  // all_of, min
+#include <utility>  // move
+
+
+namespace cqasm::v3x::parser {
+
+StringViewInputStream::StringViewInputStream(std::string_view data, std::string name)
+: data_{ data }
+, name_{ std::move(name) } {}
+
+bool StringViewInputStream::is_ascii(std::string_view data) {
+    return std::all_of(data.begin(), data.end(), [](char c) {
+        return static_cast<unsigned char>(c) < 0x80;
+    });
+}
+
+void StringViewInputStream::consume() {
+    if (position_ >= data_.size()) {
+        throw antlr4::IllegalStateException{ "cannot consume EOF" };
+    }
+    position_++;
+}
+
+// Same semantics as antlr4::ANTLRInputStream::LA:
+// LA(1) is the current character, LA(-1) the previous one, and LA(0) is undefined
+size_t StringViewInputStream::LA(ssize_t i) {
+    if (i == 0) {
+        return 0;
+    }
+    auto position = static_cast<ssize_t>(position_) + (i < 0 ? i : i - 1);
+    if (position < 0 || position >= static_cast<ssize_t>(data_.size())) {
+        return antlr4::IntStream::EOF;
+    }
+    return static_cast<unsigned char>(data_[static_cast<std::size_t>(position)]);
+}
+
+// The whole input is always available, so there is no need for marking
+ssize_t StringViewInputStream::mark() {
+    return -1;
+}
+
+void StringViewInputStream::release(ssize_t /* marker */) {}
+
+size_t StringViewInputStream::index() {
+    return position_;
+}
+
+void StringViewInputStream::seek(size_t index) {
+    position_ = std::min(index, data_.size());
+}
+
+size_t StringViewInputStream::size() {
+    return data_.size();
+}
+
+std::string StringViewInputStream::getSourceName() const {
+    return name_.empty() ? antlr4::IntStream::UNKNOWN_SOURCE_NAME : name_;
+}
+
+std::string StringViewInputStream::getText(const antlr4::misc::Interval &interval) {
+    if (interval.a < 0 || interval.b < 0) {
+        return {};
+    }
+    auto start = static_cast<std::size_t>(interval.a);
+    auto stop = static_cast<std::size_t>(interval.b);
+    if (start >= data_.size() || stop < start) {
+        return {};
+    }
+    return std::string{ data_.substr(start, stop - start + 1) };
+}
+
+std::string StringViewInputStream::toString() const {
+    return std::string{ data_ };
+}
+
+}  // namespace cqasm::v3x::parser
@@ -6,6 +6,13 @@
 
 namespace cqasm::v3x::analyzer {
 
+/**
+ * Releases the tree before the arena it is allocated from, if any.
+ */
+AnalysisResult::~AnalysisResult() {
+    root.reset();
+}
+
 /**
  * "Unwraps" the result (as you would in Rust) to get the program node or an exception.
  * The exception is always an AnalysisFailed, deriving from std::runtime_error.
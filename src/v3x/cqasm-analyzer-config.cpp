@@ -0,0 +1,112 @@
+/** \file
+ * Implementation for \ref include/v3x/cqasm-analyzer-config.hpp "v3x/cqasm-analyzer-config.hpp".
+ */
+
+#include "v3x/ConstantFolder.hpp"
+#include "v3x/cqasm-analyzer-config.hpp"
+#include "v3x/cqasm-functions.hpp"
+
+#include <numbers>
+#include <stdexcept>  // invalid_argument
+
+
+namespace cqasm::v3x::analyzer {
+
+/**
+ * Creates a new, empty, analyzer configuration.
+ */
+AnalyzerConfig::AnalyzerConfig(const primitives::Version &api_version)
+: api_version{ api_version } {
+    if (api_version != "3.0") {
+        throw std::invalid_argument{ "this analyzer only supports cQASM 3.0" };
+    }
+}
+
+/**
+ * Registers mappings for pi, eu (aka e, 2.718...), tau and im (imaginary unit).
+ */
+void AnalyzerConfig::register_default_mappings() {
+    static constexpr double tau = 2 * std::numbers::pi;
+    register_variable("x", tree::make<values::ConstAxis>(primitives::Axis{ 1, 0, 0 }));
+    register_variable("y", tree::make<values::ConstAxis>(primitives::Axis{ 0, 1, 0 }));
+    register_variable("z", tree::make<values::ConstAxis>(primitives::Axis{ 0, 0, 1 }));
+    register_variable("true", tree::make<values::ConstBool>(true));
+    register_variable("false", tree::make<values::ConstBool>(false));
+    register_variable("pi", tree::make<values::ConstFloat>(std::numbers::pi));
+    register_variable("eu", tree::make<values::ConstFloat>(std::numbers::e));
+    register_variable("tau", tree::make<values::ConstFloat>(tau));
+    register_variable("im", tree::make<values::ConstComplex>(primitives::Complex(0.0, 1.0)));
+}
+
+/**
+ * Registers a number of default functions, such as the operator functions, and the usual trigonometric functions.
+ */
+void AnalyzerConfig::register_default_functions() {
+    functions::register_default_function_impls_into(function_impl_table_);
+    has_default_function_impls_ = true;
+}
+
+/**
+ * Registers an initial mapping.
+ */
+void AnalyzerConfig::register_variable(const std::string &name, const values::Value &value) {
+    variable_table.add(name, value);
+}
+
+/**
+ * Registers a function implementation, usable within expressions.
+ */
+void AnalyzerConfig::register_function_impl(
+    const std::string &name,
+    const types::Types &param_types,
+    const resolver::FunctionImpl &impl) {
+
+    function_impl_table_.add(name, param_types, impl);
+    overrides_default_function_impls_ |= ConstantFolder::folds(name);
+}
+
+/**
+ * Convenience method for registering a function implementation.
+ * The param_types are specified as a string,
+ * converted to types::Types for the other overload using types::from_spec.
+ */
+void AnalyzerConfig::register_function_impl(
+    const std::string &name,
+    const std::string &param_types,
+    const resolver::FunctionImpl &impl) {
+
+    register_function_impl(name, types::from_spec(param_types), impl);
+}
+
+/**
+ * Registers an instruction type.
+ */
+void AnalyzerConfig::register_instruction(const instruction::Instruction &instruction) {
+    instruction_table.add(instruction);
+}
+
+/**
+ * Convenience method for registering an instruction type.
+ * The arguments are passed straight to instruction::Instruction's constructor.
+ */
+void AnalyzerConfig::register_instruction(const std::string &name, const std::optional<std::string> &param_types) {
+    register_instruction(instruction::Instruction(name, param_types));
+}
+
+/**
+ * Returns the list of function implementations.
+ * Function implementations are registered with register_default_functions() and register_function_impl().
+ */
+const resolver::FunctionImplTable &AnalyzerConfig::function_impl_table() const {
+    return function_impl_table_;
+}
+
+/**
+ * Returns whether constant expressions can be folded by a \ref ConstantFolder,
+ * i.e. whether the default functions are registered, and none of them has been overridden.
+ */
+bool AnalyzerConfig::folds_constants() const {
+    return has_default_function_impls_ && !overrides_default_function_impls_;
+}
+
+} // namespace cqasm::v3x::analyzer
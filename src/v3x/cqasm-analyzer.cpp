@@ -3,15 +3,22 @@
  */
 
 #include "cqasm-error.hpp"
+#include "cqasm-mapped-file.hpp"
+#include "cqasm-tree.hpp"
 #include "v3x/AnalyzeTreeGenAstVisitor.hpp"
 #include "v3x/cqasm-analyzer.hpp"
-#include "v3x/cqasm-functions.hpp"
 #include "v3x/cqasm-parse-helper.hpp"
 
+#include <algorithm>  // clamp
+#include <atomic>
+#include <exception>  // current_exception, exception_ptr, rethrow_exception
 #include <fmt/format.h>
-#include <memory>  // make_unique
-#include <numbers>
+#include <memory>  // make_shared, make_unique
+#include <mutex>  // lock_guard
+#include <optional>
 #include <stdexcept>  // runtime_error
+#include <system_error>
+#include <thread>
 
 
 namespace cqasm::v3x::analyzer {
@@ -22,14 +29,79 @@ namespace cqasm::v3x::analyzer {
  */
 Analyzer::Analyzer(const primitives::Version &api_version)
 : api_version{ api_version }
-, scope_stack_{ Scope{} }
-{
-    if (api_version != "3.0") {
-        throw std::invalid_argument{ "this analyzer only supports cQASM 3.0" };
+, owned_config_{ std::make_shared<AnalyzerConfig>(api_version) }
+, config_{ owned_config_ } {
+    reset_scope_stack();
+}
+
+/**
+ * Creates a new semantic analyzer that uses the given configuration.
+ * Creates a global scope.
+ */
+Analyzer::Analyzer(std::shared_ptr<const AnalyzerConfig> config)
+: api_version{ config->api_version }
+, config_{ std::move(config) } {
+    reset_scope_stack();
+}
+
+/**
+ * Copies a semantic analyzer.
+ * The copy shares the configuration of the original, and either of them copies it before modifying it.
+ */
+Analyzer::Analyzer(const Analyzer &other)
+: api_version{ other.api_version }
+, use_arena{ other.use_arena }
+, config_{ other.config_ }
+, scope_stack_{ other.scope_stack_ } {
+    other.owned_config_.reset();
+}
+
+/**
+ * Copies a semantic analyzer.
+ * The copy shares the configuration of the original, and either of them copies it before modifying it.
+ */
+Analyzer &Analyzer::operator=(const Analyzer &other) {
+    if (this != &other) {
+        api_version = other.api_version;
+        use_arena = other.use_arena;
+        owned_config_.reset();
+        config_ = other.config_;
+        scope_stack_ = other.scope_stack_;
+        other.owned_config_.reset();
+    }
+    return *this;
+}
+
+/**
+ * Returns the configuration, so that it can be modified.
+ * The configuration is copied first if it may be shared with anyone else.
+ */
+AnalyzerConfig &Analyzer::mutable_config() {
+    if (!owned_config_) {
+        owned_config_ = std::make_shared<AnalyzerConfig>(*config_);
+        config_ = owned_config_;
     }
+    return *owned_config_;
+}
+
+/**
+ * Resets the scope stack to a single, empty, global scope.
+ */
+void Analyzer::reset_scope_stack() {
+    scope_stack_.clear();
+    scope_stack_.emplace_front();
     global_scope().block = tree::make<semantic::Block>();
 }
 
+/**
+ * Returns the configuration of this analyzer, so that it can be shared with other analyzers.
+ * Later calls to the `register_*()` methods of this analyzer will not modify the returned configuration.
+ */
+std::shared_ptr<const AnalyzerConfig> Analyzer::config() const {
+    owned_config_.reset();
+    return config_;
+}
+
 [[nodiscard]] Scope &Analyzer::global_scope() { return scope_stack_.back(); }
 [[nodiscard]] Scope &Analyzer::current_scope() { return scope_stack_.front(); }
 [[nodiscard]] tree::One<semantic::Block> Analyzer::current_block() { return current_scope().block; }
@@ -45,29 +117,22 @@ Analyzer::Analyzer(const primitives::Version &api_version)
  * Registers mappings for pi, eu (aka e, 2.718...), tau and im (imaginary unit).
  */
 void Analyzer::register_default_mappings() {
-    static constexpr double tau = 2 * std::numbers::pi;
-    register_variable("x", tree::make<values::ConstAxis>(primitives::Axis{ 1, 0, 0 }));
-    register_variable("y", tree::make<values::ConstAxis>(primitives::Axis{ 0, 1, 0 }));
-    register_variable("z", tree::make<values::ConstAxis>(primitives::Axis{ 0, 0, 1 }));
-    register_variable("true", tree::make<values::ConstBool>(true));
-    register_variable("false", tree::make<values::ConstBool>(false));
-    register_variable("pi", tree::make<values::ConstFloat>(std::numbers::pi));
-    register_variable("eu", tree::make<values::ConstFloat>(std::numbers::e));
-    register_variable("tau", tree::make<values::ConstFloat>(tau));
-    register_variable("im", tree::make<values::ConstComplex>(primitives::Complex(0.0, 1.0)));
+    mutable_config().register_default_mappings();
 }
 
 /**
  * Registers a number of default functions, such as the operator functions, and the usual trigonometric functions.
  */
 void Analyzer::register_default_functions() {
-    functions::register_default_function_impls_into(global_scope().function_impl_table);
+    mutable_config().register_default_functions();
 }
 
 /**
  * Analyzes the given AST.
+ * Every call starts from an empty global scope.
  */
 AnalysisResult Analyzer::analyze(ast::Program &ast) {
+    reset_scope_stack();
     auto analyze_visitor_up = std::make_unique<AnalyzeTreeGenAstVisitor>(*this);
     auto result = std::any_cast<AnalysisResult>(analyze_visitor_up->visit_program(ast));
     if (result.errors.empty() && !result.root.is_well_formed()) {
@@ -99,27 +164,50 @@ AnalysisResult Analyzer::analyze(
     const std::function<version::Version()> &version_parser,
     const std::function<parser::ParseResult()> &parser) {
 
-    AnalysisResult result;
-    try {
-        if (auto version = version_parser(); version > api_version) {
-            result.errors.emplace_back(fmt::format(
-                "cQASM file version is {}, but at most {} is supported here", version, api_version));
+    auto parse_and_analyze = [&]() -> AnalysisResult {
+        AnalysisResult result;
+        try {
+            if (auto version = version_parser(); version > api_version) {
+                result.errors.emplace_back(fmt::format(
+                    "cQASM file version is {}, but at most {} is supported here", version, api_version));
+                return result;
+            }
+        } catch (error::AnalysisError &err) {
+            result.errors.push_back(std::move(err));
             return result;
         }
-    } catch (error::AnalysisError &err) {
-        result.errors.push_back(std::move(err));
-        return result;
+        return analyze(parser());
+    };
+    if (!use_arena) {
+        return parse_and_analyze();
+    }
+
+    // The result owns the arena, so that the tree is released in one go with the result.
+    // The scopes also hold nodes allocated from the arena, so they are reset while it is still alive
+    auto arena = std::make_shared<tree::Arena>();
+    AnalysisResult result;
+    try {
+        tree::ArenaScope arena_scope{ *arena };
+        result = parse_and_analyze();
+    } catch (...) {
+        reset_scope_stack();
+        throw;
     }
-    return analyze(parser());
+    reset_scope_stack();
+    result.arena = std::move(arena);
+    return result;
 }
 
 /**
  * Parses and analyzes the given file.
+ * The file is mapped only once, and its contents shared by the version check and the parser.
  */
 AnalysisResult Analyzer::analyze_file(const std::string &file_name) {
+    // The file is mapped only once, by the version parser closure, which is always run first
+    std::optional<utils::MappedFile> file{};
     return analyze(
-        [=](){ return version::parse_file(file_name); },
-        [=](){ return parser::parse_file(file_name, file_name); }
+        [&](){ file.emplace(file_name); return version::parse_view(file->data(), file_name); },
+        [&](){ return parser::parse_view(file->data(), file_name); }
     );
 }
 
@@ -134,6 +222,69 @@ AnalysisResult Analyzer::analyze_string(const std::string &data, const std::opti
     );
 }
 
+/**
+ * Parses and analyzes each of the given programs, concurrently, using up to thread_count threads.
+ * A thread_count of 0 means as many threads as the hardware supports.
+ * Every thread analyzes programs one after the other with its own Analyzer,
+ * sharing this analyzer's configuration.
+ * Overrides of the virtual methods of this class are thus not used.
+ * Returns the results in the same order as the programs.
+ */
+std::vector<AnalysisResult> Analyzer::analyze_batch(
+    std::span<const std::string_view> programs, std::size_t thread_count) const {
+
+    std::vector<AnalysisResult> results(programs.size());
+    if (thread_count == 0) {
+        thread_count = std::thread::hardware_concurrency();
+    }
+    thread_count = std::clamp(thread_count, std::size_t{ 1 }, std::max(programs.size(), std::size_t{ 1 }));
+
+    // Workers pick the next pending program as soon as they are done with the previous one,
+    // so that a few long programs do not leave the other workers idle
+    std::atomic<std::size_t> next_index{ 0 };
+    std::exception_ptr exception{};
+    std::mutex exception_mutex{};
+    auto work = [&]() {
+        try {
+            Analyzer analyzer{ config_ };
+            analyzer.api_version = api_version;
+            analyzer.use_arena = use_arena;
+            for (auto index = next_index++; index < programs.size(); index = next_index++) {
+                const auto &data = programs[index];
+                results[index] = analyzer.analyze(
+                    [&](){ return version::parse_view(data, std::nullopt); },
+                    [&](){ return parser::parse_view(data, std::nullopt); }
+                );
+            }
+        } catch (...) {
+            // Stop all the workers, and rethrow the first exception once they have finished
+            next_index = programs.size();
+            std::lock_guard lock{ exception_mutex };
+            if (!exception) {
+                exception = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> workers{};
+    workers.reserve(thread_count - 1);
+    for (std::size_t i = 1; i < thread_count; ++i) {
+        try {
+            workers.emplace_back(work);
+        } catch (const std::system_error &) {
+            break;  // carry on with fewer threads
+        }
+    }
+    work();
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+    return results;
+}
+
 /**
  * Pushes a new empty scope to the top of the scope stack.
  */
@@ -172,10 +323,11 @@ void Analyzer::add_statement_to_current_scope(const tree::One<semantic::Statemen
 }
 
 /**
- * Adds a variable to the current scope.
+ * Adds a variable to the current scope, and registers a reference to it under its name.
  */
 void Analyzer::add_variable_to_current_scope(const tree::One<semantic::Variable> &variable) {
     current_variables().add(variable);
+    current_scope().variable_table.add(variable->name, tree::make<values::VariableRef>(variable));
 }
 
 /**
@@ -188,23 +340,26 @@ void Analyzer::add_function_to_global_scope(const tree::One<semantic::Function>
 /**
  * Resolves a variable.
  * Throws NameResolutionFailure if no variable by the given name exists.
+ * The value is shared with the variable table, so it must be copied before being modified or added to a tree.
  */
 values::Value Analyzer::resolve_variable(const std::string &name) const {
     for (const auto &scope : scope_stack_) {
-        try {
-            return scope.variable_table.resolve(name);
-        } catch (const error::AnalysisError &) {
-            continue;
+        if (const auto *value = scope.variable_table.find(name)) {
+            return *value;
         }
     }
+    if (const auto *value = config_->variable_table.find(name)) {
+        return *value;
+    }
     throw resolver::NameResolutionFailure{ fmt::format("failed to resolve variable '{}'", name) };
 }
 
 /**
- * Registers a variable.
+ * Registers an initial mapping, visible to all the programs analyzed afterwards.
+ * The variables declared by a program are registered by add_variable_to_current_scope instead.
  */
 void Analyzer::register_variable(const std::string &name, const values::Value &value) {
-    current_scope().variable_table.add(name, value);
+    mutable_config().register_variable(name, value);
 }
 
 /**
@@ -214,7 +369,7 @@ void Analyzer::register_variable(const std::string &name, const values::Value &v
  * or otherwise returns the value returned by the function.
  */
 values::Value Analyzer::resolve_function_impl(const std::string &name, const values::Values &args) const {
-    return global_scope().function_impl_table.resolve(name, args);
+    return config_->function_impl_table().resolve(name, args);
 }
 
 /**
@@ -227,7 +382,7 @@ values::Value Analyzer::resolve_function_impl(const std::string &name, const val
  */
 values::Value Analyzer::resolve_function(const std::string &name, const values::Values &args) const {
     try {
-        return global_scope().function_impl_table.resolve(name, args);
+        return config_->function_impl_table().resolve(name, args);
     } catch (const error::AnalysisError &) {}
     return global_scope().function_table.resolve(name, args);
 }
@@ -240,7 +395,7 @@ void Analyzer::register_function_impl(
     const types::Types &param_types,
     const resolver::FunctionImpl &impl) {
 
-    global_scope().function_impl_table.add(name, param_types, impl);
+    mutable_config().register_function_impl(name, param_types, impl);
 }
 
 /**
@@ -253,7 +408,7 @@ void Analyzer::register_function_impl(
     const std::string &param_types,
     const resolver::FunctionImpl &impl) {
 
-    global_scope().function_impl_table.add(name, types::from_spec(param_types), impl);
+    mutable_config().register_function_impl(name, param_types, impl);
 }
 
 /**
@@ -277,13 +432,9 @@ void Analyzer::register_function(
 [[nodiscard]] tree::One<semantic::Instruction> Analyzer::resolve_instruction(
     const std::string &name, const values::Values &args) const {
 
-    for (const auto &scope : scope_stack_) {
-        try {
-            return scope.instruction_table.resolve(name,  args);
-        } catch (const error::AnalysisError &) {
-            continue;
-        }
-    }
+    try {
+        return config_->instruction_table.resolve(name, args);
+    } catch (const error::AnalysisError &) {}
     throw resolver::ResolutionFailure{
         fmt::format("failed to resolve instruction '{}' with argument pack {}", name, values::types_of(args)) };
 }
@@ -292,7 +443,7 @@ void Analyzer::register_function(
  * Registers an instruction type.
  */
 void Analyzer::register_instruction(const instruction::Instruction &instruction) {
-    current_scope().instruction_table.add(instruction);
+    mutable_config().register_instruction(instruction);
 }
 
 /**
@@ -300,7 +451,7 @@ void Analyzer::register_instruction(const instruction::Instruction &instruction)
  * The arguments are passed straight to instruction::Instruction's constructor.
  */
 void Analyzer::register_instruction(const std::string &name, const std::optional<std::string> &param_types) {
-    register_instruction(instruction::Instruction(name, param_types));
+    mutable_config().register_instruction(name, param_types);
 }
 
 } // namespace cqasm::v3x::analyzer
@@ -2,10 +2,93 @@
 
 namespace cqasm::v3x::functions {
 
+namespace {
+
+/**
+ * Registers a binary element-wise function for an array and an array, an array and a scalar, and a scalar and an array.
+ * array and scalar are the type specifications of the array and scalar parameters, e.g. 'Z' and 'f'.
+ */
+void add_element_wise(
+    resolver::FunctionImplTable &table,
+    const std::string &name,
+    char array,
+    char scalar,
+    const resolver::FunctionImpl &impl) {
+
+    table.add(name, types::from_spec(std::string{ array, array }), impl);
+    table.add(name, types::from_spec(std::string{ array, scalar }), impl);
+    table.add(name, types::from_spec(std::string{ scalar, array }), impl);
+}
+
+}  // namespace
+
+/**
+ * Registers the element-wise overloads of the default functions, for constant arrays, into the given function table.
+ */
+void register_default_array_function_impls_into(resolver::FunctionImplTable &table) {
+    table.add("operator-", types::from_spec("Z"), op_neg_Z);
+    table.add("operator-", types::from_spec("Y"), op_neg_Y);
+
+    add_element_wise(table, "operator+", 'Z', 'f', op_add_Z);
+    add_element_wise(table, "operator+", 'Y', 'i', op_add_Y);
+    add_element_wise(table, "operator-", 'Z', 'f', op_sub_Z);
+    add_element_wise(table, "operator-", 'Y', 'i', op_sub_Y);
+
+    add_element_wise(table, "operator*", 'Z', 'f', op_mul_Z);
+    add_element_wise(table, "operator*", 'Y', 'i', op_mul_Y);
+    add_element_wise(table, "operator/", 'Z', 'f', op_div_Z);
+    add_element_wise(table, "operator/", 'Y', 'i', op_div_Y);
+    add_element_wise(table, "operator%", 'Y', 'i', op_mod_Y);
+
+    add_element_wise(table, "operator**", 'Z', 'f', op_pow_Z);
+
+    add_element_wise(table, "operator==", 'Z', 'f', op_eq_Z);
+    add_element_wise(table, "operator!=", 'Z', 'f', op_ne_Z);
+    add_element_wise(table, "operator>=", 'Z', 'f', op_ge_Z);
+    add_element_wise(table, "operator>", 'Z', 'f', op_gt_Z);
+    add_element_wise(table, "operator<=", 'Z', 'f', op_le_Z);
+    add_element_wise(table, "operator<", 'Z', 'f', op_lt_Z);
+
+    add_element_wise(table, "operator==", 'Y', 'i', op_eq_Y);
+    add_element_wise(table, "operator!=", 'Y', 'i', op_ne_Y);
+    add_element_wise(table, "operator>=", 'Y', 'i', op_ge_Y);
+    add_element_wise(table, "operator>", 'Y', 'i', op_gt_Y);
+    add_element_wise(table, "operator<=", 'Y', 'i', op_le_Y);
+    add_element_wise(table, "operator<", 'Y', 'i', op_lt_Y);
+
+    add_element_wise(table, "operator==", 'X', 'b', op_eq_X);
+    add_element_wise(table, "operator!=", 'X', 'b', op_ne_X);
+    add_element_wise(table, "operator>=", 'X', 'b', op_ge_X);
+    add_element_wise(table, "operator>", 'X', 'b', op_gt_X);
+    add_element_wise(table, "operator<=", 'X', 'b', op_le_X);
+    add_element_wise(table, "operator<", 'X', 'b', op_lt_X);
+
+    table.add("sqrt", types::from_spec("Z"), fn_sqrt_Z);
+    table.add("exp", types::from_spec("Z"), fn_exp_Z);
+    table.add("log", types::from_spec("Z"), fn_log_Z);
+    table.add("sin", types::from_spec("Z"), fn_sin_Z);
+    table.add("cos", types::from_spec("Z"), fn_cos_Z);
+    table.add("tan", types::from_spec("Z"), fn_tan_Z);
+    table.add("sinh", types::from_spec("Z"), fn_sinh_Z);
+    table.add("cosh", types::from_spec("Z"), fn_cosh_Z);
+    table.add("tanh", types::from_spec("Z"), fn_tanh_Z);
+    table.add("asin", types::from_spec("Z"), fn_asin_Z);
+    table.add("acos", types::from_spec("Z"), fn_acos_Z);
+    table.add("atan", types::from_spec("Z"), fn_atan_Z);
+    table.add("asinh", types::from_spec("Z"), fn_asinh_Z);
+    table.add("acosh", types::from_spec("Z"), fn_acosh_Z);
+    table.add("atanh", types::from_spec("Z"), fn_atanh_Z);
+    table.add("abs", types::from_spec("Z"), fn_abs_Z);
+    table.add("abs", types::from_spec("Y"), fn_abs_Y);
+}
+
 /**
  * Registers a bunch of functions for which we have a C++ implementation into the given function table.
+ * The array overloads are registered first, so that the scalar overloads are tried first.
  */
 void register_default_function_impls_into(resolver::FunctionImplTable &table) {
+    register_default_array_function_impls_into(table);
+
     table.add("operator-", types::from_spec("f"), op_neg_f);
     table.add("operator-", types::from_spec("i"), op_neg_i);
 
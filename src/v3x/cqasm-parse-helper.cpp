@@ -9,6 +9,10 @@
 #include "v3x/cqasm-parse-helper.hpp"
 #include "v3x/cqasm-parse-result.hpp"
 
+#include <fmt/format.h>
+#include <initializer_list>
+#include <stdexcept>  // runtime_error
+
 
 namespace cqasm::v3x::parser {
 
@@ -17,27 +21,121 @@ namespace cqasm::v3x::parser {
  * Throws a ParseError if the file does not exist.
  * A file_name may be given in addition for use within error messages.
  */
-ParseResult parse_file(const std::string &file_path, const std::optional<std::string> &file_name) {
+ParseResult parse_file(const std::string &file_path, const std::optional<std::string> &file_name,
+    PredictionMode prediction_mode) {
     auto builder_visitor_up = std::make_unique<BuildTreeGenAstVisitor>(file_name);
     auto error_listener_up = std::make_unique<CustomErrorListener>(file_name);
     auto scanner_up = std::make_unique<ScannerAntlrFile>(
-        std::move(builder_visitor_up), std::move(error_listener_up), file_path);
+        std::move(builder_visitor_up), std::move(error_listener_up), file_path, prediction_mode);
     return ParseHelper(std::move(scanner_up), file_name).parse();
 }
 
 /**
  * Parse the given string.
  * A file_name may be given in addition for use within error messages.
+ * The prediction_mode only affects parsing speed, see PredictionMode.
+ */
+ParseResult parse_string(const std::string &data, const std::optional<std::string> &file_name,
+    PredictionMode prediction_mode) {
+    return parse_view(data, file_name, prediction_mode);
+}
+
+/**
+ * Same as parse_string, but scans a caller-owned buffer, e.g. a memory-mapped file, without copying it.
+ * The data only has to stay alive for the duration of the call.
  */
-ParseResult parse_string(const std::string &data, const std::optional<std::string> &file_name) {
+ParseResult parse_view(std::string_view data, const std::optional<std::string> &file_name,
+    PredictionMode prediction_mode) {
     auto builder_visitor_up = std::make_unique<BuildTreeGenAstVisitor>(file_name);
     auto error_listener_up = std::make_unique<CustomErrorListener>(file_name);
-    auto scanner_up = std::make_unique<ScannerAntlrString>(
-        std::move(builder_visitor_up), std::move(error_listener_up), data);
+    auto scanner_up = std::make_unique<ScannerAntlrView>(
+        std::move(builder_visitor_up), std::move(error_listener_up), data, prediction_mode);
     return ParseHelper(std::move(scanner_up), file_name).parse();
 }
 
 
+/**
+ * Program used by warm_up.
+ * It is syntactically correct, and goes through every alternative of every rule of the grammar.
+ */
+static constexpr std::string_view warm_up_program = R"(// Warm-up program
+/* Exercises every alternative of every rule of the grammar */
+version 3.0
+
+qubit q0
+qubit[4] q
+bit b0
+bit[4] b
+axis a = [1, 0, 0]
+bool c = true
+bool[2] cs = {true, false}
+int i = +1 - -2 * 3 / 4 % 5 ** 6
+int[3] is = {1, 2, 3}
+float f = 1.5e-3 + .5 + 2.
+float[2] fs = {pi, tau}
+c = (i << 1 >> 2) > 0 && i < 1 || i >= 2 ^^ i <= 3
+i = ~i & 1 ^ 2 | 3
+c = !c ? i == 1 : i != 2
+f = sin(f)
+g(1, 2.0)
+H q[0]
+CNOT q[0:1], q[2, 3]
+b = measure q
+b[0] = measure q[0]; X q0
+
+def g(int n, float x) -> float {
+    int m = n
+    return m * x
+}
+def h(qubit r) {
+    X r
+}
+def k() {}
+)";
+
+/**
+ * Fills the lexer and parser DFA caches by parsing a built-in program that exercises every rule of the grammar,
+ * once with each PredictionMode, so that the first parses are fast whichever mode they use.
+ * The DFA caches are shared by all the parsers in the process, and otherwise only fill in lazily,
+ * which makes the first parses in a process much slower than the following ones.
+ * Throws a runtime_error if the built-in program does not parse without errors,
+ * as it would then stop short of some of the rules.
+ */
+void warm_up() {
+    for (auto prediction_mode : { PredictionMode::sll_first, PredictionMode::ll }) {
+        if (auto result = parse_view(warm_up_program, std::nullopt, prediction_mode); !result.errors.empty()) {
+            throw std::runtime_error{ fmt::format(
+                "internal error: the warm-up program does not parse: {}", result.errors.front().what()) };
+        }
+    }
+}
+
+/**
+ * Returns the number of states in the DFA cache of the parser.
+ */
+std::size_t dfa_cache_size() {
+    return ScannerAntlr::dfa_cache_size();
+}
+
+/**
+ * Clears the DFA caches of the lexer and the parser.
+ * Waits for the parses in progress to finish.
+ */
+void clear_dfa_cache() {
+    ScannerAntlr::clear_dfa_cache();
+}
+
+/**
+ * Bounds the DFA cache of the parser to max_states states, 0 meaning no bound.
+ * Useful for long-running processes parsing very diverse inputs.
+ * The bound is checked before each parse, if no other parse is in progress at that moment,
+ * and the DFA caches are cleared when it is exceeded.
+ */
+void set_dfa_cache_limit(std::size_t max_states) {
+    ScannerAntlr::set_dfa_cache_limit(max_states);
+}
+
+
 ParseHelper::ParseHelper(std::unique_ptr<ScannerAdaptor> scanner_up, const std::optional<std::string> &file_name)
 : scanner_up_{ std::move(scanner_up) }
 , file_name_{ file_name.value_or(annotations::unknown_file_name) }
@@ -2,17 +2,24 @@
  * Implementation for the internal Python-wrapped functions and classes.
  */
 
+#include "cqasm-mapped-file.hpp"
+#include "cqasm-py-result-conversion.hpp"
 #include "cqasm-version.hpp"
 #include "v3x/cqasm-analyzer.hpp"
 #include "v3x/cqasm-parse-helper.hpp"
 #include "v3x/cqasm-py.hpp"
 #include "v3x/cqasm.hpp"
 
+#include <algorithm>  // transform
+#include <iterator>  // back_inserter
 #include <memory>
 #include <optional>
+#include <string_view>
 
 namespace v3x = cqasm::v3x;
 
+using cqasm::result::to_py_result;
+
 /**
  * Creates a new v3.x semantic analyzer.
  * When without_defaults is specified,
@@ -52,12 +59,10 @@ void V3xAnalyzer::register_instruction(const std::string &name, const std::strin
  * Only parses the given file.
  * The file must be in v3.x syntax.
  * No version check or conversion is performed.
- * Returns a vector of strings, of which the first is reserved for the CBOR serialization of the v3.x AST.
- * Any additional strings represent error messages.
- * Notice that the AST and error messages won't be available at the same time.
+ * Returns a PyResult with either the CBOR serialization of the v3.x AST, or the error messages.
  */
-std::vector<std::string> V3xAnalyzer::parse_file(const std::string &file_name) {
-    return v3x::parser::parse_file(file_name, std::nullopt).to_strings();
+PyResult V3xAnalyzer::parse_file(const std::string &file_name) {
+    return to_py_result(v3x::parser::parse_file(file_name, std::nullopt));
 }
 
 /**
@@ -78,9 +83,9 @@ std::string V3xAnalyzer::parse_file_to_json(const std::string &file_name) {
  * Same as parse_file(), but instead receives the file contents directly.
  * The file_name, if non-empty, is only used when reporting errors.
  */
-std::vector<std::string> V3xAnalyzer::parse_string(const std::string &data, const std::string &file_name) {
+PyResult V3xAnalyzer::parse_string(const std::string &data, const std::string &file_name) {
     auto file_name_op = !file_name.empty() ? std::optional<std::string>{ file_name } : std::nullopt;
-    return v3x::parser::parse_string(data, file_name_op).to_strings();
+    return to_py_result(v3x::parser::parse_string(data, file_name_op));
 }
 
 /**
@@ -99,20 +104,43 @@ std::string V3xAnalyzer::parse_string_to_json(const std::string &data, const std
     return v3x::parser::parse_string(data, file_name_op).to_json();
 }
 
+/**
+ * Fills the parser caches, shared by all the analyzers in the process,
+ * so that the first parses are as fast as the following ones.
+ */
+void V3xAnalyzer::warm_up() {
+    v3x::parser::warm_up();
+}
+
+/**
+ * Clears the parser caches.
+ */
+void V3xAnalyzer::clear_dfa_cache() {
+    v3x::parser::clear_dfa_cache();
+}
+
+/**
+ * Bounds the parser caches to max_states states, 0 meaning no bound.
+ * The caches are cleared when the bound is exceeded.
+ */
+void V3xAnalyzer::set_dfa_cache_limit(std::size_t max_states) {
+    v3x::parser::set_dfa_cache_limit(max_states);
+}
+
 /**
  * Parses and analyzes the given file.
  * If the file is written in a later file version,
  * this function may try to reduce it to the maximum v3.x API version support advertised
  * using this object's constructor.
- * Returns a vector of strings, of which the first is reserved for the CBOR serialization of the v3.x semantic tree.
- * Any additional strings represent error messages.
- * Notice that the AST and error messages won't be available at the same time.
- */
-std::vector<std::string> V3xAnalyzer::analyze_file(const std::string &file_name) const {
-    return analyzer->analyze(
-        [=](){ return cqasm::version::parse_file(file_name); },
-        [=](){ return v3x::parser::parse_file(file_name, std::nullopt); }
-    ).to_strings();
+ * Returns a PyResult with either the CBOR serialization of the v3.x semantic tree, or the error messages.
+ */
+PyResult V3xAnalyzer::analyze_file(const std::string &file_name) const {
+    // The file is mapped only once, by the version parser closure, which is always run first
+    std::optional<cqasm::utils::MappedFile> file{};
+    return to_py_result(v3x::analyzer::Analyzer{ analyzer->config() }.analyze(
+        [&](){ file.emplace(file_name); return cqasm::version::parse_view(file->data(), file_name); },
+        [&](){ return v3x::parser::parse_view(file->data(), std::nullopt); }
+    ));
 }
 
 /**
@@ -126,9 +154,11 @@ std::vector<std::string> V3xAnalyzer::analyze_file(const std::string &file_name)
  * severity is hardcoded to 1 at the moment (value corresponding to an Error level).
  */
 [[nodiscard]] std::string V3xAnalyzer::analyze_file_to_json(const std::string &file_name) const {
-    return analyzer->analyze(
-        [=](){ return cqasm::version::parse_file(file_name); },
-        [=](){ return v3x::parser::parse_file(file_name, std::nullopt); }
+    // The file is mapped only once, by the version parser closure, which is always run first
+    std::optional<cqasm::utils::MappedFile> file{};
+    return v3x::analyzer::Analyzer{ analyzer->config() }.analyze(
+        [&](){ file.emplace(file_name); return cqasm::version::parse_view(file->data(), file_name); },
+        [&](){ return v3x::parser::parse_view(file->data(), std::nullopt); }
     ).to_json();
 }
 
@@ -136,14 +166,14 @@ std::vector<std::string> V3xAnalyzer::analyze_file(const std::string &file_name)
  * Same as analyze_file(), but instead receives the file contents directly.
  * The file_name, if specified, is only used when reporting errors.
  */
-std::vector<std::string> V3xAnalyzer::analyze_string(
+PyResult V3xAnalyzer::analyze_string(
     const std::string &data, const std::string &file_name) const {
 
     auto file_name_op = !file_name.empty() ? std::optional<std::string>{ file_name } : std::nullopt;
-    return analyzer->analyze(
+    return to_py_result(v3x::analyzer::Analyzer{ analyzer->config() }.analyze(
         [=](){ return cqasm::version::parse_string(data, file_name_op); },
         [=](){ return v3x::parser::parse_string(data, file_name_op); }
-    ).to_strings();
+    ));
 }
 
 /**
@@ -161,8 +191,25 @@ std::vector<std::string> V3xAnalyzer::analyze_string(
     const std::string &data, const std::string &file_name) const {
 
     auto file_name_op = !file_name.empty() ? std::optional<std::string>{ file_name } : std::nullopt;
-    return analyzer->analyze(
+    return v3x::analyzer::Analyzer{ analyzer->config() }.analyze(
         [=](){ return cqasm::version::parse_string(data, file_name_op); },
         [=](){ return v3x::parser::parse_string(data, file_name_op); }
     ).to_json();
 }
+
+/**
+ * Same as analyze_string(), but for a list of programs, analyzed concurrently using up to thread_count threads.
+ * A thread_count of 0 means as many threads as the hardware supports.
+ * Returns one PyResult per program, in the same order as the programs.
+ */
+std::vector<PyResult> V3xAnalyzer::analyze_batch(
+    const std::vector<std::string> &data, std::size_t thread_count) const {
+
+    std::vector<std::string_view> programs{ data.begin(), data.end() };
+    auto results = analyzer->analyze_batch(programs, thread_count);
+    std::vector<PyResult> ret{};
+    ret.reserve(results.size());
+    std::transform(results.begin(), results.end(), std::back_inserter(ret),
+        [](const auto &result) { return to_py_result(result); });
+    return ret;
+}
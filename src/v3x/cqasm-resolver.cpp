@@ -31,13 +31,25 @@ void VariableTable::add(const std::string &name, const Value &value) {
     table.insert(std::make_pair(name, value));
 }
 
+/**
+ * Returns the value of a variable, or nullptr if no variable by the given name exists.
+ * The value is shared with this table, so it must not be modified nor added to a tree.
+ */
+const Value *VariableTable::find(const std::string &name) const {
+    if (auto entry = table.find(name); entry != table.end()) {
+        return &entry->second;
+    }
+    return nullptr;
+}
+
 /**
  * Resolves a variable.
  * Throws NameResolutionFailure if no variable by the given name exists.
+ * The value is shared with this table, so it must be copied before being modified or added to a tree.
  */
 Value VariableTable::resolve(const std::string &name) const {
-    if (auto entry = table.find(name); entry != table.end()) {
-        return entry->second->clone();
+    if (const auto *value = find(name)) {
+        return *value;
     }
     throw NameResolutionFailure{ fmt::format("failed to resolve variable '{}'", name) };
 }
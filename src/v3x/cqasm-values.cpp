@@ -9,6 +9,7 @@
 #include "v3x/cqasm-semantic.hpp"
 
 #include <fmt/format.h>
+#include <numeric>  // accumulate
 #include <ostream>
 #include <stdexcept>  // runtime_error
 
@@ -27,7 +28,8 @@ namespace cqasm::v3x::values {
 */
 Value promote(const Value &value, const types::Type &type) {
     // If the types match exactly, just return the original value
-    if (types::type_check(type, type_of(value))) {
+    const auto value_type = type_of(value);
+    if (types::type_check(type, value_type)) {
         return value;
     }
 
@@ -38,7 +40,7 @@ Value promote(const Value &value, const types::Type &type) {
         if (const auto &const_bool = value->as_const_bool()) {
             ret = tree::make<values::ConstInt>(static_cast<ConstInt>(const_bool->value));
         } else if (value->as_variable_ref() || value->as_function_call()) {
-            if (types::type_check(type_of(value), tree::make<types::Bool>())) {
+            if (types::type_check(value_type, types::interned<types::Bool>())) {
                 ret = value;
             }
         }
@@ -48,7 +50,7 @@ Value promote(const Value &value, const types::Type &type) {
         if (const auto &const_bool_array = value->as_const_bool_array()) {
             ret = promote_array_value_to_array_type<ConstBoolArray, ConstIntArray, types::Int>(const_bool_array);
         } else if (value->as_variable_ref() || value->as_function_call()) {
-            if (types::type_check(type_of(value), tree::make<types::BoolArray>())) {
+            if (types::type_check(value_type, types::interned<types::BoolArray>())) {
                 ret = value;
             }
         }
@@ -61,8 +63,8 @@ Value promote(const Value &value, const types::Type &type) {
         } else if (const auto &const_int = value->as_const_int()) {
             ret = tree::make<values::ConstFloat>(static_cast<ConstFloat>(static_cast<double>(const_int->value)));
         } else if (value->as_variable_ref() || value->as_function_call()) {
-            if (types::type_check(type_of(value), tree::make<types::Bool>()) ||
-                types::type_check(type_of(value), tree::make<types::Int>())) {
+            if (types::type_check(value_type, types::interned<types::Bool>()) ||
+                types::type_check(value_type, types::interned<types::Int>())) {
                 ret = value;
             }
         }
@@ -74,8 +76,8 @@ Value promote(const Value &value, const types::Type &type) {
         } else if (const auto &const_int_array = value->as_const_int_array()) {
             ret = promote_array_value_to_array_type<ConstIntArray, ConstFloatArray, types::Float>(const_int_array);
         } else if (value->as_variable_ref() || value->as_function_call()) {
-            if (types::type_check(type_of(value), tree::make<types::BoolArray>()) ||
-                types::type_check(type_of(value), tree::make<types::IntArray>())) {
+            if (types::type_check(value_type, types::interned<types::BoolArray>()) ||
+                types::type_check(value_type, types::interned<types::IntArray>())) {
                 ret = value;
             }
         }
@@ -90,9 +92,9 @@ Value promote(const Value &value, const types::Type &type) {
         } else if (const auto &const_float = value->as_const_float()) {
             ret = tree::make<values::ConstComplex>(static_cast<ConstComplex>(const_float->value));
         } else if (value->as_variable_ref() || value->as_function_call()) {
-            if (types::type_check(type_of(value), tree::make<types::Bool>()) ||
-                types::type_check(type_of(value), tree::make<types::Int>()) ||
-                types::type_check(type_of(value), tree::make<types::Float>())) {
+            if (types::type_check(value_type, types::interned<types::Bool>()) ||
+                types::type_check(value_type, types::interned<types::Int>()) ||
+                types::type_check(value_type, types::interned<types::Float>())) {
                 ret = value;
             }
         }
@@ -115,10 +117,10 @@ Value promote(const Value &value, const types::Type &type) {
                 ret = tree::make<values::ConstFloatArray>(const_float_array->value);
             }
         } else if (value->as_variable_ref() || value->as_function_call()) {
-            if (types::type_check(type_of(value), tree::make<types::BoolArray>()) ||
-                types::type_check(type_of(value), tree::make<types::IntArray>()) ||
-                types::type_check(type_of(value), tree::make<types::FloatArray>())) {
-                if (types::size_of(type_of(value)) == 3) {
+            if (types::type_check(value_type, types::interned<types::BoolArray>()) ||
+                types::type_check(value_type, types::interned<types::IntArray>()) ||
+                types::type_check(value_type, types::interned<types::FloatArray>())) {
+                if (types::size_of(value_type) == 3) {
                     ret = value;
                 }
             }
@@ -149,21 +151,40 @@ bool check_promote(const types::Type &from_type, const types::Type &to_type) {
     return false;
 }
 
+/**
+ * Returns a key identifying the given value as far as promotion is concerned:
+ * values with the same key can be promoted to exactly the same types.
+ * Used to memoize overload resolutions.
+ *
+ * Promotion depends on the kind of value (e.g. a constant or a variable reference),
+ * on the kind of its type, and on its number of elements.
+ * The latter is taken from the value, not from its type,
+ * because the type of a constant array does not hold the array size.
+ */
+cqasm::overload::PromotionKey promotion_key(const Value &value) {
+    return cqasm::overload::PromotionKey{
+        static_cast<int>(value->type()),
+        static_cast<int>(type_of(value)->type()),
+        false,
+        { static_cast<std::size_t>(size_of(value)), 0 }
+    };
+}
+
 /**
  * Returns the element type of the given type.
  * Throws an error if the given type is not of array type.
  */
 types::Type element_type_of(const types::Type &type) {
-    if (types::type_check(type, tree::make<types::QubitArray>())) {
-        return tree::make<types::Qubit>();
-    } else if (types::type_check(type, tree::make<types::BitArray>())) {
-        return tree::make<types::Bit>();
-    } else if (types::type_check(type, tree::make<types::BoolArray>())) {
-        return tree::make<types::Bool>();
-    } else if (types::type_check(type, tree::make<types::IntArray>())) {
-        return tree::make<types::Int>();
-    } else if (types::type_check(type, tree::make<types::FloatArray>())) {
-        return tree::make<types::Float>();
+    if (types::type_check(type, types::interned<types::QubitArray>())) {
+        return types::interned<types::Qubit>();
+    } else if (types::type_check(type, types::interned<types::BitArray>())) {
+        return types::interned<types::Bit>();
+    } else if (types::type_check(type, types::interned<types::BoolArray>())) {
+        return types::interned<types::Bool>();
+    } else if (types::type_check(type, types::interned<types::IntArray>())) {
+        return types::interned<types::Int>();
+    } else if (types::type_check(type, types::interned<types::FloatArray>())) {
+        return types::interned<types::Float>();
     } else {
         throw std::runtime_error{ fmt::format("type ({}) is not of array type", type) };
     }
@@ -174,21 +195,21 @@ types::Type element_type_of(const types::Type &type) {
  */
 types::Type type_of(const Value &value) {
     if (value->as_const_axis()) {
-        return tree::make<types::Axis>();
+        return types::interned<types::Axis>();
     } else if (value->as_const_bool()) {
-        return tree::make<types::Bool>();
+        return types::interned<types::Bool>();
     } else if (value->as_const_int()) {
-        return tree::make<types::Int>();
+        return types::interned<types::Int>();
     } else if (value->as_const_float()) {
-        return tree::make<types::Float>();
+        return types::interned<types::Float>();
     } else if (value->as_const_complex()) {
-        return tree::make<types::Complex>();
+        return types::interned<types::Complex>();
     } else if (value->as_const_bool_array()) {
-        return tree::make<types::BoolArray>();
+        return types::interned<types::BoolArray>();
     } else if (value->as_const_int_array()) {
-        return tree::make<types::IntArray>();
+        return types::interned<types::IntArray>();
     } else if (value->as_const_float_array()) {
-        return tree::make<types::FloatArray>();
+        return types::interned<types::FloatArray>();
     } else if (auto index = value->as_index_ref()) {
         // If the size of the index is 1, return the type of the element (qubit, bit, bool...)
         // Otherwise, return the type of the variable it refers to (qubit array, bit array, bool array...)
@@ -235,7 +256,7 @@ primitives::Int size_of(const Value &value) {
     } else if (auto float_array = value->as_const_float_array()) {
         return static_cast<primitives::Int>(float_array->value.size());
     } else if (auto index = value->as_index_ref()) {
-        return static_cast<primitives::Int>(index->indices.size());
+        return size_of(index->indices);
     } else if (auto var = value->as_variable_ref()) {
         return types::size_of(var->variable->typ);
     } else if (auto function_ref_ptr = value->as_function_ref()) {
@@ -254,6 +275,29 @@ primitives::Int size_of(const Value &value) {
     }
 }
 
+/**
+ * Returns the number of indices in the given index ranges.
+ */
+primitives::Int size_of(const tree::Many<IndexRange> &indices) {
+    return std::accumulate(indices.begin(), indices.end(), primitives::Int{ 0 },
+        [](primitives::Int acc, const auto &range) { return acc + range->last - range->first + 1; });
+}
+
+/**
+ * Returns the individual indices in the given index ranges, in order.
+ * Index ranges are only expanded on demand, by the consumers that need every single index.
+ */
+std::vector<primitives::Int> expand_indices(const tree::Many<IndexRange> &indices) {
+    std::vector<primitives::Int> ret{};
+    ret.reserve(static_cast<std::size_t>(size_of(indices)));
+    for (const auto &range : indices) {
+        for (auto index = range->first; index <= range->last; ++index) {
+            ret.push_back(index);
+        }
+    }
+    return ret;
+}
+
 /**
  * Throws an AnalysisError if the given value is not a constant,
  * i.e. if it doesn't have a known value at this time.
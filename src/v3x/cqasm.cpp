@@ -6,10 +6,13 @@
  * Implementation for \ref include/v3x/cqasm.hpp "v3x/cqasm.hpp".
  */
 
+#include "cqasm-mapped-file.hpp"
 #include "cqasm-version.hpp"
 #include "v3x/cqasm.hpp"
 #include "v3x/cqasm-parse-helper.hpp"
 
+#include <memory>  // make_shared, shared_ptr
+#include <optional>
 #include <stdexcept>  // runtime_error
 
 
@@ -23,9 +26,11 @@ tree::One<cqasm::v3x::semantic::Program> analyze_file(
     const std::string &file_path,
     const std::string &api_version
 ) {
+    // The file is mapped only once, by the version parser closure, which is always run first
+    std::optional<utils::MappedFile> file{};
     return cqasm::v3x::default_analyzer(api_version).analyze(
-        [&file_path]() { return version::parse_file(file_path); },
-        [&file_path]() { return cqasm::v3x::parser::parse_file(file_path, std::nullopt); }
+        [&file_path, &file]() { file.emplace(file_path); return version::parse_view(file->data(), file_path); },
+        [&file]() { return cqasm::v3x::parser::parse_view(file->data(), std::nullopt); }
     ).unwrap();
 }
 
@@ -45,64 +50,89 @@ tree::One<cqasm::v3x::semantic::Program> analyze_string(
     ).unwrap();
 }
 
+namespace {
+
 /**
- * Constructs an Analyzer object with the defaults for cQASM 3.0 already loaded into it.
+ * Builds an analyzer configuration with the defaults for cQASM 3.0.
  */
-analyzer::Analyzer default_analyzer(const std::string &api_version) {
-    analyzer::Analyzer analyzer{ api_version };
+std::shared_ptr<const analyzer::AnalyzerConfig> build_default_analyzer_config(const std::string &api_version) {
+    auto config = std::make_shared<analyzer::AnalyzerConfig>(api_version);
+
+    config->register_default_mappings();
+    config->register_default_functions();
+
+    config->register_instruction("cnot", "QQ");
+    config->register_instruction("cnot", "QV");
+    config->register_instruction("cnot", "VQ");
+    config->register_instruction("cnot", "VV");
+    config->register_instruction("cr", "QQf");
+    config->register_instruction("cr", "QVf");
+    config->register_instruction("cr", "VQf");
+    config->register_instruction("cr", "VVf");
+    config->register_instruction("crk", "QQi");
+    config->register_instruction("crk", "QVi");
+    config->register_instruction("crk", "VQi");
+    config->register_instruction("crk", "VVi");
+    config->register_instruction("cz", "QQ");
+    config->register_instruction("cz", "QV");
+    config->register_instruction("cz", "VQ");
+    config->register_instruction("cz", "VV");
+    config->register_instruction("h", "Q");
+    config->register_instruction("h", "V");
+    config->register_instruction("i", "Q");
+    config->register_instruction("measure", "BQ");
+    config->register_instruction("measure", "WV");
+    config->register_instruction("measure", "BV");
+    config->register_instruction("measure", "WQ");
+    config->register_instruction("mx90", "Q");
+    config->register_instruction("mx90", "V");
+    config->register_instruction("my90", "Q");
+    config->register_instruction("my90", "V");
+    config->register_instruction("rx", "Qf");
+    config->register_instruction("rx", "Vf");
+    config->register_instruction("ry", "Qf");
+    config->register_instruction("ry", "Vf");
+    config->register_instruction("rz", "Qf");
+    config->register_instruction("rz", "Vf");
+    config->register_instruction("s", "Q");
+    config->register_instruction("s", "V");
+    config->register_instruction("sdag", "Q");
+    config->register_instruction("sdag", "V");
+    config->register_instruction("x", "Q");
+    config->register_instruction("x", "V");
+    config->register_instruction("x90", "Q");
+    config->register_instruction("x90", "V");
+    config->register_instruction("y", "Q");
+    config->register_instruction("y", "V");
+    config->register_instruction("y90", "Q");
+    config->register_instruction("y90", "V");
+    config->register_instruction("z", "Q");
+    config->register_instruction("z", "V");
+
+    return config;
+}
 
-    analyzer.register_default_mappings();
-    analyzer.register_default_functions();
+}  // namespace
 
-    analyzer.register_instruction("cnot", "QQ");
-    analyzer.register_instruction("cnot", "QV");
-    analyzer.register_instruction("cnot", "VQ");
-    analyzer.register_instruction("cnot", "VV");
-    analyzer.register_instruction("cr", "QQf");
-    analyzer.register_instruction("cr", "QVf");
-    analyzer.register_instruction("cr", "VQf");
-    analyzer.register_instruction("cr", "VVf");
-    analyzer.register_instruction("crk", "QQi");
-    analyzer.register_instruction("crk", "QVi");
-    analyzer.register_instruction("crk", "VQi");
-    analyzer.register_instruction("crk", "VVi");
-    analyzer.register_instruction("cz", "QQ");
-    analyzer.register_instruction("cz", "QV");
-    analyzer.register_instruction("cz", "VQ");
-    analyzer.register_instruction("cz", "VV");
-    analyzer.register_instruction("h", "Q");
-    analyzer.register_instruction("h", "V");
-    analyzer.register_instruction("i", "Q");
-    analyzer.register_instruction("measure", "BQ");
-    analyzer.register_instruction("measure", "WV");
-    analyzer.register_instruction("measure", "BV");
-    analyzer.register_instruction("measure", "WQ");
-    analyzer.register_instruction("mx90", "Q");
-    analyzer.register_instruction("mx90", "V");
-    analyzer.register_instruction("my90", "Q");
-    analyzer.register_instruction("my90", "V");
-    analyzer.register_instruction("rx", "Qf");
-    analyzer.register_instruction("rx", "Vf");
-    analyzer.register_instruction("ry", "Qf");
-    analyzer.register_instruction("ry", "Vf");
-    analyzer.register_instruction("rz", "Qf");
-    analyzer.register_instruction("rz", "Vf");
-    analyzer.register_instruction("s", "Q");
-    analyzer.register_instruction("s", "V");
-    analyzer.register_instruction("sdag", "Q");
-    analyzer.register_instruction("sdag", "V");
-    analyzer.register_instruction("x", "Q");
-    analyzer.register_instruction("x", "V");
-    analyzer.register_instruction("x90", "Q");
-    analyzer.register_instruction("x90", "V");
-    analyzer.register_instruction("y", "Q");
-    analyzer.register_instruction("y", "V");
-    analyzer.register_instruction("y90", "Q");
-    analyzer.register_instruction("y90", "V");
-    analyzer.register_instruction("z", "Q");
-    analyzer.register_instruction("z", "V");
+/**
+ * Returns an analyzer configuration with the defaults for cQASM 3.0 already loaded into it.
+ * The configuration for the default API version is built only once, the first time it is requested,
+ * and then shared by all the callers.
+ */
+std::shared_ptr<const analyzer::AnalyzerConfig> default_analyzer_config(const std::string &api_version) {
+    static const auto default_config = build_default_analyzer_config("3.0");
+    if (primitives::Version{ api_version } == default_config->api_version) {
+        return default_config;
+    }
+    return build_default_analyzer_config(api_version);
+}
 
-    return analyzer;
+/**
+ * Constructs an Analyzer object with the defaults for cQASM 3.0 already loaded into it.
+ * The default configuration is shared, not copied, so this is cheap.
+ */
+analyzer::Analyzer default_analyzer(const std::string &api_version) {
+    return analyzer::Analyzer{ default_analyzer_config(api_version) };
 }
 
 } // namespace cqasm::v3x
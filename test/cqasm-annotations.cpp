@@ -40,3 +40,38 @@ TEST(source_location_constructor, unknown_file_name__yes_line_numbers__yes_colum
     auto location = SourceLocation{ "<unknown file name>", { { 10, 12 }, { 10, 15 } } };
     EXPECT_EQ(fmt::format("{}", location), "<unknown file name>:10:12..15");
 }
+TEST(source_location_constructor, shared_file_name__yes_line_numbers__yes_column_numbers) {
+    auto location = SourceLocation{ FileName{ "input.cq" }, { { 10, 12 }, { 10, 15 } } };
+    EXPECT_EQ(fmt::format("{}", location), "input.cq:10:12..15");
+}
+
+TEST(file_name, locations_constructed_from_the_same_file_name_share_storage) {
+    auto file_name = FileName{ "input.cq" };
+    auto first = SourceLocation{ file_name, { { 1, 1 }, { 1, 2 } } };
+    auto second = SourceLocation{ file_name, { { 2, 1 }, { 2, 2 } } };
+    ASSERT_TRUE(first.file_name.has_value() && second.file_name.has_value());
+    EXPECT_EQ(&first.file_name->str(), &second.file_name->str());
+    EXPECT_EQ(first.file_name, second.file_name);
+    EXPECT_EQ(first.file_name, "input.cq");
+}
+TEST(file_name, separately_constructed_equal_names_compare_equal) {
+    auto first = FileName{ "input.cq" };
+    auto second = FileName{ "input.cq" };
+    EXPECT_NE(&first.str(), &second.str());
+    EXPECT_EQ(first, second);
+}
+TEST(file_name, name_outlives_the_file_name_it_was_copied_from) {
+    auto location = SourceLocation{};
+    {
+        auto file_name = FileName{ "input.cq" };
+        location = SourceLocation{ file_name, { { 1, 1 }, { 1, 2 } } };
+    }
+    EXPECT_EQ(location.file_name, "input.cq");
+}
+TEST(file_name, different_names) {
+    auto first = FileName{ "input.cq" };
+    auto second = FileName{ "other.cq" };
+    EXPECT_NE(first, second);
+    EXPECT_NE(&first.str(), &second.str());
+    EXPECT_EQ(second, "other.cq");
+}
@@ -0,0 +1,13 @@
+#include "cqasm-error.hpp"
+#include "cqasm-mapped-file.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace cqasm::utils;
+
+
+TEST(MappedFile, file_does_not_exist) {
+    EXPECT_THROW(MappedFile{ "res/cqasm_version/does_not_exist.cq" }, cqasm::error::ParseError);
+}
+TEST(MappedFile, empty_file) { EXPECT_TRUE(MappedFile{ "res/cqasm_version/empty.cq" }.data().empty()); }
+TEST(MappedFile, non_empty_file) { EXPECT_EQ(MappedFile{ "res/cqasm_version/version_1_0.cq" }.data(), "version 1.0\n"); }
@@ -84,3 +84,17 @@ TEST(to_json, v3x_analyzer_ast) {
     };
     EXPECT_EQ(json_result, expected_json_result);
 }
+
+TEST(to_cbor, v3x_analyzer_errors) {
+    auto input_file_path = fs::path{"res"}/"v3x"/"parsing"/"bit_array_definition"/"bit_array_of_0_b"/"input.cq";
+    auto semantic_ast_result = cqasm::v3x::default_analyzer().analyze_file(input_file_path.generic_string());
+    EXPECT_TRUE(to_cbor(semantic_ast_result).empty());
+    auto strings = to_strings(semantic_ast_result);
+    EXPECT_EQ(to_error_messages(semantic_ast_result), (std::vector<std::string>{ std::next(strings.begin()), strings.end() }));
+}
+TEST(to_cbor, v3x_analyzer_ast) {
+    auto input_file_path = fs::path{"res"}/"v3x"/"parsing"/"bit_array_definition"/"bit_array_of_17_b"/"input.cq";
+    auto semantic_ast_result = cqasm::v3x::default_analyzer().analyze_file(input_file_path.generic_string());
+    EXPECT_TRUE(to_error_messages(semantic_ast_result).empty());
+    EXPECT_EQ(to_cbor(semantic_ast_result), to_strings(semantic_ast_result).front());
+}
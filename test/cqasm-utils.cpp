@@ -1,6 +1,10 @@
+#include "cqasm-error.hpp"
 #include "cqasm-utils.hpp"
 
 #include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 
 using namespace cqasm::utils;
 
@@ -39,3 +43,22 @@ TEST(json_encode, error) {
         json_encode("failed to parse 'res/v1x/parsing/grammar/expression_recovery/input.cq'"),
         "failed to parse 'res/v1x/parsing/grammar/expression_recovery/input.cq'");
 }
+
+
+TEST(read_file, file_does_not_exist) {
+    EXPECT_THROW(read_file("res/cqasm_version/does_not_exist.cq"), cqasm::error::ParseError);
+}
+TEST(read_file, empty_file) { EXPECT_TRUE(read_file("res/cqasm_version/empty.cq").empty()); }
+TEST(read_file, non_empty_file) { EXPECT_EQ(read_file("res/cqasm_version/version_1_0.cq"), "version 1.0\n"); }
+
+TEST(CaseInsensitiveHash, equal_for_strings_differing_in_case) {
+    EXPECT_EQ(CaseInsensitiveHash{}("abCD_12"), CaseInsensitiveHash{}("ABcd_12"));
+    EXPECT_EQ(CaseInsensitiveHash{}(""), CaseInsensitiveHash{}(std::string{}));
+}
+TEST(CaseInsensitiveHash, unordered_map_lookup_ignores_case) {
+    std::unordered_map<std::string, int, CaseInsensitiveHash, CaseInsensitiveEqual> map{ { "cnot", 1 }, { "X90", 2 } };
+    EXPECT_EQ(map.at("CNOT"), 1);
+    EXPECT_EQ(map.at("x90"), 2);
+    EXPECT_EQ(map.find(std::string_view{ "CNot" })->second, 1);
+    EXPECT_EQ(map.count("cz"), 0);
+}
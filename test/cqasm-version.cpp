@@ -341,3 +341,21 @@ TEST(ParseHelper_parse, scanner_throws_and_no_filename_argument) {
     EXPECT_THAT([&]() { ParseHelper(std::move(scanner_up), std::nullopt).parse(); },
         ThrowsMessage<ParseError>(HasSubstr("Error at <unknown file name>:1:1: syntax error")));
 }
+
+TEST(VersionLiteral, components) {
+    static_assert(VersionLiteral{ "1.2" }.components().size() == 2);
+    static_assert(VersionLiteral{ "1.2" }.components()[1] == 2);
+    static_assert(VersionLiteral{ "10.0.3" }.components()[0] == 10);
+    EXPECT_THAT(VersionLiteral{ "1.1.1" }.components(), ElementsAre(1, 1, 1));
+}
+TEST(VersionLiteral, compares_like_a_version) {
+    EXPECT_TRUE(Version{ "1.2" } == VersionLiteral{ "1.2" });
+    EXPECT_TRUE(Version{ "1.2" } == VersionLiteral{ "1.2.0" });
+    EXPECT_TRUE(Version{ "1.2.0" } == VersionLiteral{ "1.2" });
+    EXPECT_TRUE(Version{ "1.1" } < VersionLiteral{ "1.2" });
+    EXPECT_TRUE(Version{ "1.1.1" } < VersionLiteral{ "1.2" });
+    EXPECT_TRUE(Version{ "1.2.1" } > VersionLiteral{ "1.2" });
+    EXPECT_TRUE(Version{ "3.0" } >= VersionLiteral{ "1.2" });
+    EXPECT_TRUE(VersionLiteral{ "1.2" } <= Version{ "1.2" });
+    EXPECT_TRUE(Version{} < VersionLiteral{ "0.1" });
+}
@@ -0,0 +1,199 @@
+#include "v1x/cqasm.hpp"
+
+#include <fmt/format.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace cq1x = cqasm::v1x;
+
+
+namespace {
+
+/**
+ * Returns the index of the qubit the first operand of the first instruction of a bundle refers to.
+ */
+cq1x::primitives::Int first_qubit_index(const cq1x::semantic::Statement &statement) {
+    const auto &insn = statement.as_bundle_ext()->items[0]->as_instruction();
+    return insn->operands[0]->as_qubit_refs()->index[0]->first;
+}
+
+}  // namespace
+
+
+TEST(analyzer, mapping_in_a_block_shadows_the_enclosing_one_only_within_the_block) {
+    auto program = cq1x::analyze_string(R"(
+version 1.2
+qubits 3
+var c: bool
+map target = q[0]
+if (c) {
+    map target = q[1]
+    while (c) {
+        x target
+        map target = q[2]
+        x target
+    }
+    x target
+}
+x target
+)", std::nullopt, "1.2");
+
+    const auto &statements = program->subcircuits[0]->body->statements;
+    ASSERT_EQ(statements.size(), 2);
+    const auto &if_body = statements[0]->as_if_else()->branches[0]->body->statements;
+    ASSERT_EQ(if_body.size(), 2);
+    const auto &while_body = if_body[0]->as_while_loop()->body->statements;
+    ASSERT_EQ(while_body.size(), 2);
+    EXPECT_EQ(first_qubit_index(*while_body[0]), 1);
+    EXPECT_EQ(first_qubit_index(*while_body[1]), 2);
+    EXPECT_EQ(first_qubit_index(*if_body[1]), 1);
+    EXPECT_EQ(first_qubit_index(*statements[1]), 0);
+}
+
+TEST(analyzer, mapping_in_a_block_is_not_visible_after_the_block) {
+    EXPECT_THROW(cq1x::analyze_string(R"(
+version 1.2
+qubits 2
+var c: bool
+if (c) {
+    map target = q[1]
+}
+x target
+)", std::nullopt, "1.2"), cq1x::analyzer::AnalysisFailed);
+}
+
+TEST(analyzer, only_the_global_mappings_of_the_program_are_saved) {
+    auto program = cq1x::analyze_string(R"(
+version 1.2
+qubits 2
+var c: bool
+map outer = q[0]
+if (c) {
+    map inner = q[1]
+}
+)", std::nullopt, "1.2");
+
+    ASSERT_EQ(program->mappings.size(), 1);
+    EXPECT_EQ(program->mappings[0]->name, "outer");
+}
+
+TEST(analyzer, names_are_resolved_case_insensitively) {
+    auto program = cq1x::analyze_string(R"(
+version 1.0
+qubits 2
+error_model Depolarizing_Channel, 0.001
+map Target = q[1]
+X TARGET
+CNot q[0], target
+)", std::nullopt);
+
+    ASSERT_FALSE(program->error_model.empty());
+    EXPECT_EQ(program->error_model->name, "depolarizing_channel");
+    ASSERT_EQ(program->mappings.size(), 1);
+    EXPECT_EQ(program->mappings[0]->name, "target");
+    const auto &bundles = program->subcircuits[0]->bundles;
+    ASSERT_EQ(bundles.size(), 2);
+    const auto &x = bundles[0]->items[0];
+    EXPECT_EQ(x->name, "x");
+    EXPECT_EQ(x->operands[0]->as_qubit_refs()->index[0]->first, 1);
+    const auto &cnot = bundles[1]->items[0];
+    EXPECT_EQ(cnot->name, "cnot");
+    EXPECT_EQ(cnot->operands[1]->as_qubit_refs()->index[0]->first, 1);
+}
+
+TEST(analyzer, indexing_qubit_refs_maps_the_index_ranges_of_the_indexed_refs) {
+    auto program = cq1x::analyze_string(R"(
+version 1.0
+qubits 6
+map x = q[5, 1:3]
+h x[1:3, 0]
+)", std::nullopt);
+
+    const auto &h = program->subcircuits[0]->bundles[0]->items[0];
+    const auto &index = h->operands[0]->as_qubit_refs()->index;
+    ASSERT_EQ(index.size(), 2);
+    EXPECT_EQ(cq1x::values::expand_indices(index), (std::vector<cq1x::primitives::Int>{ 1, 2, 3, 5 }));
+    EXPECT_EQ(cq1x::values::size_of(index), 4);
+
+    // Every index range keeps the source location of its index entry
+    const auto &location_1_3 = index[0]->get_annotation<cq1x::parser::SourceLocation>().range;
+    const auto &location_0 = index[1]->get_annotation<cq1x::parser::SourceLocation>().range;
+    EXPECT_EQ(location_1_3.first.line, 5);
+    EXPECT_LT(location_1_3.last, location_0.first);
+}
+
+TEST(analyzer, qubit_reused_across_index_ranges_is_reported_at_its_first_index) {
+    auto analyzer = cq1x::default_analyzer("1.0");
+    auto result = analyzer.analyze_string("version 1.0\nqubits 4\ncnot q[1:2], q[0, 2]\n", std::nullopt);
+    ASSERT_EQ(result.errors.size(), 1);
+    EXPECT_THAT(fmt::format("{}", result.errors[0]), ::testing::HasSubstr("qubit with index 2 is used more than once"));
+    result = analyzer.analyze_string("version 1.0\nqubits 4\ncnot q[2:3], q[0:1]\n", std::nullopt);
+    EXPECT_TRUE(result.errors.empty());
+    result = analyzer.analyze_string("version 1.0\nqubits 4\ncnot q[2:3], q[0:2]\n", std::nullopt);
+    ASSERT_EQ(result.errors.size(), 1);
+    EXPECT_THAT(fmt::format("{}", result.errors[0]), ::testing::HasSubstr("qubit with index 2 is used more than once"));
+}
+
+TEST(analyzer, streaming_hands_the_bundles_over_in_program_order) {
+    const std::string data = R"(
+version 1.0
+qubits 3
+error_model depolarizing_channel, 0.001
+map target = q[2]
+.init
+prep_z q[0]
+.body(2)
+x target
+{ h q[0] | h q[1] }
+)";
+    auto analyzer = cq1x::default_analyzer("1.1");
+    std::vector<std::string> bundles{};
+    auto result = analyzer.analyze_stream_string(data, std::nullopt,
+        [&](const cq1x::semantic::Program &program,
+            const cq1x::semantic::Subcircuit &subcircuit,
+            cqasm::tree::One<cq1x::semantic::Bundle> bundle) {
+            EXPECT_EQ(program.num_qubits, 3);
+            EXPECT_FALSE(program.error_model.empty());
+            EXPECT_TRUE(subcircuit.bundles.empty());
+            std::string text = subcircuit.name + ":";
+            for (const auto &insn : bundle->items) {
+                text += fmt::format(" {} q[{}]", insn->name, insn->operands[0]->as_qubit_refs()->index[0]->first);
+            }
+            bundles.push_back(text);
+        });
+    ASSERT_TRUE(result.errors.empty());
+    EXPECT_THAT(bundles, ::testing::ElementsAre("init: prep_z q[0]", "body: x q[2]", "body: h q[0] h q[1]"));
+
+    // Apart from the bundles, the program is the same as that of the analysis of the whole program.
+    const auto &program = *result.root;
+    auto whole_program = analyzer.analyze_string(data, std::nullopt).root;
+    ASSERT_EQ(program.subcircuits.size(), 2);
+    EXPECT_EQ(program.subcircuits[1]->iterations, 2);
+    EXPECT_TRUE(program.subcircuits[1]->bundles.empty());
+    EXPECT_EQ(whole_program->subcircuits[1]->bundles.size(), 2);
+    ASSERT_EQ(program.mappings.size(), 1);
+    EXPECT_EQ(program.mappings[0]->name, "target");
+    EXPECT_EQ(program.error_model->name, whole_program->error_model->name);
+    EXPECT_EQ(program.version->items, whole_program->version->items);
+}
+
+TEST(analyzer, streaming_requires_the_error_model_before_the_first_bundle) {
+    auto result = cq1x::default_analyzer("1.0").analyze_stream_string(R"(
+version 1.0
+qubits 2
+x q[0]
+error_model depolarizing_channel, 0.001
+)", std::nullopt, [](const auto &, const auto &, auto) {});
+    ASSERT_EQ(result.errors.size(), 1);
+    EXPECT_THAT(fmt::format("{}", result.errors[0]), ::testing::HasSubstr("must precede the first bundle"));
+}
+
+TEST(analyzer, streaming_needs_a_bundle_based_semantic_tree) {
+    auto analyzer = cq1x::default_analyzer("1.2");
+    EXPECT_THROW(analyzer.analyze_stream_string("version 1.0\nqubits 1\n", std::nullopt,
+        [](const auto &, const auto &, auto) {}), std::invalid_argument);
+}
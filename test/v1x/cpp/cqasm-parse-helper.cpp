@@ -3,12 +3,225 @@
 #include "v1x/cqasm-parse-result.hpp"
 #include "v1x/cqasm-parse-helper.hpp"
 
+#include <algorithm>  // max
+#include <cstddef>  // size_t
+#include <cstdio>
+#include <fmt/format.h>
 #include <gmock/gmock.h>
+#include <memory_resource>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 using namespace ::testing;
 using namespace cqasm::error;
 using namespace cqasm::v1x::parser;
 
 
+/**
+ * Memory resource keeping track of the peak number of bytes allocated from it at the same time.
+ */
+class CountingResource : public std::pmr::memory_resource {
+    std::size_t in_use_ = 0;
+    std::size_t peak_ = 0;
+
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        in_use_ += bytes;
+        peak_ = std::max(peak_, in_use_);
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+        in_use_ -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+public:
+    [[nodiscard]] std::size_t peak() const { return peak_; }
+};
+
+TEST(token_strings, store_returns_a_null_terminated_copy) {
+    TokenStrings token_strings;
+    std::string text{ "3.14" };
+    const auto *stored = token_strings.store(text);
+    text[0] = '2';
+    EXPECT_STREQ(stored, "3.14");
+    EXPECT_STREQ(token_strings.store(""), "");
+}
+
+TEST(token_strings, intern_returns_the_same_string_for_equal_texts) {
+    TokenStrings token_strings;
+    const auto *q = token_strings.intern("q");
+    const auto *x = token_strings.intern(std::string{ "xq" }.substr(0, 1));
+    EXPECT_STREQ(q, "q");
+    EXPECT_STREQ(x, "x");
+    EXPECT_EQ(token_strings.intern(std::string{ "q" }), q);
+    EXPECT_EQ(token_strings.intern("x"), x);
+    EXPECT_NE(token_strings.store("q"), q);
+}
+
+TEST(token_strings, strings_stay_valid_while_more_are_added) {
+    TokenStrings token_strings;
+    const auto *first = token_strings.intern("first");
+    const auto *stored = token_strings.store("stored");
+    // 32 strings of 4 KB take the buffers through several growth steps, and the names several rehashes
+    const std::string long_text(4'096, 'a');
+    for (int i = 0; i < 32; ++i) {
+        token_strings.intern("name_" + std::to_string(i));
+        token_strings.store(long_text);
+    }
+    EXPECT_STREQ(first, "first");
+    EXPECT_STREQ(stored, "stored");
+    EXPECT_EQ(token_strings.intern("first"), first);
+    EXPECT_EQ(token_strings.intern("name_0"), token_strings.intern(std::string{ "name_0" }));
+}
+
+TEST(token_strings, recycle_keeps_the_interned_strings_and_the_last_stored_ones) {
+    TokenStrings token_strings;
+    const auto *q = token_strings.intern("q");
+    token_strings.store("0.25");
+    token_strings.recycle();
+    const auto *lookahead = token_strings.store("0.5");
+    token_strings.recycle();
+    EXPECT_STREQ(lookahead, "0.5");
+    EXPECT_EQ(token_strings.intern("q"), q);
+    EXPECT_STREQ(q, "q");
+}
+
+TEST(token_strings, memory_does_not_grow_with_the_statement_count_when_recycled) {
+    // What the lexer stores for a statement such as rx q[3], 0.25, recycled after it as a streaming parse does
+    const auto peak_memory = [](int statement_count) {
+        CountingResource upstream{};
+        TokenStrings token_strings{ &upstream };
+        const std::string angle(64, '1');
+        for (int i = 0; i < statement_count; ++i) {
+            token_strings.intern("rx");
+            token_strings.intern("q");
+            token_strings.store("3");
+            token_strings.store(angle);
+            token_strings.recycle();
+        }
+        return upstream.peak();
+    };
+    EXPECT_EQ(peak_memory(100'000), peak_memory(100));
+}
+
+TEST(parse_string, identifiers_and_literals_keep_their_text) {
+    auto result = parse_string(R"(version 1.0
+qubits 2
+map target = q[1]
+rx target, 0.25
+rx target, 0.5
+display "a \"b\"" # comment
+)", "input.cq");
+    ASSERT_TRUE(result.errors.empty());
+    const auto &program = *result.root->as_program();
+    const auto &statements = program.statements->items;
+    ASSERT_EQ(statements.size(), 4);
+    EXPECT_EQ(statements[0]->as_mapping()->alias->name, "target");
+    const auto &insn = statements[1]->as_bundle()->items[0];
+    EXPECT_EQ(insn->name->name, "rx");
+    EXPECT_EQ(insn->operands->items[0]->as_identifier()->name, "target");
+    EXPECT_DOUBLE_EQ(insn->operands->items[1]->as_float_literal()->value, 0.25);
+    const auto &display = statements[3]->as_bundle()->items[0];
+    EXPECT_EQ(display->operands->items[0]->as_string_literal()->value, "a \"b\"");
+}
+
+TEST(parse_view, scanning_a_view_and_a_file_builds_the_same_ast) {
+    // Larger than the buffer of the scanner, so that the input is read in several chunks
+    std::string data{ "version 1.0\nqubits 2\n" };
+    for (int i = 0; i < 10'000; ++i) {
+        data += fmt::format("rx q[{}], 0.{}  # comment\n", i % 2, i);
+    }
+    auto view_result = parse_view(data, "input.cq");
+    ASSERT_TRUE(view_result.errors.empty());
+
+    auto *file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    std::fputs(data.c_str(), file);
+    std::rewind(file);
+    auto file_result = parse_file(file, "input.cq");
+    std::fclose(file);
+    ASSERT_TRUE(file_result.errors.empty());
+
+    std::ostringstream view_oss{};
+    std::ostringstream file_oss{};
+    view_oss << *view_result.root;
+    file_oss << *file_result.root;
+    EXPECT_EQ(view_oss.str(), file_oss.str());
+
+    const auto &statements = view_result.root->as_program()->statements->items;
+    ASSERT_EQ(statements.size(), 10'000);
+    const auto &location = statements.back()->get_annotation<cqasm::annotations::SourceLocation>();
+    EXPECT_EQ(location.range.first.line, 10'002);
+}
+
+TEST(parse_view, next_line_directive_sets_the_line_of_the_following_locations) {
+    auto parse_result = parse_view("version 1.0\nqubits 2\n@@NEXT_LINE=100\nx q[0\n", "input.cq");
+    ASSERT_EQ(parse_result.errors.size(), 1);
+    EXPECT_THAT(fmt::format("{}", parse_result.errors[0]), StartsWith("Error at input.cq:100:"));
+}
+
+TEST(parse_file, file_does_not_exist) {
+    auto parse_result = parse_file("res/v1x/does_not_exist.cq");
+    ASSERT_EQ(parse_result.errors.size(), 1);
+    EXPECT_THAT(fmt::format("{}", parse_result.errors[0]), HasSubstr("failed to open input file"));
+}
+
+TEST(parse_stream, top_level_statements_are_handed_over_after_the_header) {
+    std::vector<std::string> events{};
+    auto parse_result = parse_stream(R"(version 1.2
+qubits 2
+var c: bool
+x q[0]
+if (c) {
+    x q[1]
+    y q[1]
+}
+rx q[1], 0.5
+)", "input.cq", {
+        [&](const cqasm::v1x::ast::Version &version, const cqasm::v1x::ast::Expression *num_qubits) {
+            ASSERT_NE(num_qubits, nullptr);
+            events.push_back(fmt::format("version {}, qubits {}",
+                version.items, num_qubits->as_integer_literal()->value));
+        },
+        [&](const cqasm::v1x::ast::Statement &statement) {
+            if (auto bundle = statement.as_bundle()) {
+                events.push_back(bundle->items[0]->name->name);
+            } else if (statement.as_if_else()) {
+                events.push_back("if");
+            } else {
+                events.push_back("other");
+            }
+        }
+    });
+    ASSERT_TRUE(parse_result.errors.empty());
+    EXPECT_THAT(events, ElementsAre("version 1.2, qubits 2", "other", "x", "if", "rx"));
+    EXPECT_TRUE(parse_result.root->as_program()->statements->items.empty());
+}
+
+TEST(parse_stream, header_is_handed_over_for_a_program_without_statements) {
+    int header_count = 0;
+    auto parse_result = parse_stream("version 1.1\n", std::nullopt, {
+        [&](const cqasm::v1x::ast::Version &, const cqasm::v1x::ast::Expression *num_qubits) {
+            EXPECT_EQ(num_qubits, nullptr);
+            ++header_count;
+        },
+        [&](const cqasm::v1x::ast::Statement &) { ADD_FAILURE(); }
+    });
+    ASSERT_TRUE(parse_result.errors.empty());
+    EXPECT_EQ(header_count, 1);
+}
+
+TEST(parse_stream, nothing_is_handed_over_after_a_parse_error) {
+    int statement_count = 0;
+    auto parse_result = parse_stream("version 1.0\nqubits 2\nx q[0]\nx q[0\nx q[1]\n", std::nullopt, {
+        [&](const cqasm::v1x::ast::Version &, const cqasm::v1x::ast::Expression *) {},
+        [&](const cqasm::v1x::ast::Statement &) { ++statement_count; }
+    });
+    EXPECT_FALSE(parse_result.errors.empty());
+    EXPECT_EQ(statement_count, 1);
+}
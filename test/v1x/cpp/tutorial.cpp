@@ -91,8 +91,11 @@ TEST(tutorial, tutorial) {
     // number of qubits referenced for each operand must obviously be the same
     // for that reason, otherwise these semantics make no sense! libqasm checks
     // this to make sure this is the case.
-    EXPECT_EQ(qubit_refs->index.size(), 4); // four qubits
-    EXPECT_EQ(qubit_refs->index[0]->value, 0); // first qubit index
+    // The qubits are stored as ranges of consecutive indices, so that q[0:3]
+    // takes a single node no matter how many qubits it refers to.
+    EXPECT_EQ(cq1x::values::size_of(qubit_refs->index), 4); // four qubits
+    EXPECT_EQ(qubit_refs->index.size(), 1); // in a single range
+    EXPECT_EQ(qubit_refs->index[0]->first, 0); // first qubit index
 
     // Note that everything's using -> instead of . for accessing members,
     // implying that everything's a pointer. That's not entirely true; they're
@@ -102,7 +105,7 @@ TEST(tutorial, tutorial) {
     //
     //  - instead of comparing to nullptr or casting to boolean to do a null
     //    check, you need to use the empty() method. This is primarily to avoid
-    //    you from accidentally forgetting a ->value for constant integer nodes
+    //    you from accidentally forgetting a ->first for index range nodes
     //    like above; C++ would implicitly cast the boolean indicating whether
     //    the node is filled to an integer otherwise!
     //
@@ -120,23 +123,23 @@ TEST(tutorial, tutorial) {
     //    operator just copies the pointer! Observe:
 
     // Still four qubits:
-    EXPECT_EQ(hadamard_insn->operands[0]->as_qubit_refs()->index.size(), 4);
+    EXPECT_EQ(cq1x::values::size_of(hadamard_insn->operands[0]->as_qubit_refs()->index), 4);
 
     // Adding one to a different reference to the same thing:
-    qubit_refs->index.add(cqasm::tree::make<cq1x::values::ConstInt>(6));
+    qubit_refs->index.add(cqasm::tree::make<cq1x::values::IndexRange>(6, 6));
 
     // Now we have five in the original.
-    EXPECT_EQ(hadamard_insn->operands[0]->as_qubit_refs()->index.size(), 5);
+    EXPECT_EQ(cq1x::values::size_of(hadamard_insn->operands[0]->as_qubit_refs()->index), 5);
 
     // But if we make a clone:
     auto clone = hadamard_insn->operands[0]->clone();
 
     // And add another one:
-    qubit_refs->index.add(cqasm::tree::make<cq1x::values::ConstInt>(7));
+    qubit_refs->index.add(cqasm::tree::make<cq1x::values::IndexRange>(7, 7));
 
     // We have six in the original, but still have five in the clone.
-    EXPECT_EQ(hadamard_insn->operands[0]->as_qubit_refs()->index.size(), 6);
-    EXPECT_EQ(clone->as_qubit_refs()->index.size(), 5);
+    EXPECT_EQ(cq1x::values::size_of(hadamard_insn->operands[0]->as_qubit_refs()->index), 6);
+    EXPECT_EQ(cq1x::values::size_of(clone->as_qubit_refs()->index), 5);
 
     // Note that the clone() method knows what type it is. You wouldn't be able
     // to copy (in this case) cq1x::values::Node using its constructor, because
@@ -210,7 +213,7 @@ TEST(tutorial, tutorial) {
     EXPECT_TRUE(clone2 != clone); // compares by pointer
     EXPECT_TRUE(clone2.get_ptr() != clone.get_ptr()); // also compares by pointer
 
-    clone2->as_qubit_refs()->index.add(cqasm::tree::make<cq1x::values::ConstInt>(7));
+    clone2->as_qubit_refs()->index.add(cqasm::tree::make<cq1x::values::IndexRange>(7, 7));
     EXPECT_TRUE(clone2 != clone);
 
     // All tree nodes and the One/Maybe/Many/Any nodes also have operator<<
@@ -221,20 +224,13 @@ TEST(tutorial, tutorial) {
     EXPECT_EQ(ss.str(),
 R"(QubitRefs( # res/v1x/grover.cq:10:9..15
   index: [
-    ConstInt( # res/v1x/grover.cq:10:11..14
-      value: 0
+    IndexRange( # res/v1x/grover.cq:10:11..14
+      first: 0
+      last: 3
     )
-    ConstInt( # res/v1x/grover.cq:10:11..14
-      value: 1
-    )
-    ConstInt( # res/v1x/grover.cq:10:11..14
-      value: 2
-    )
-    ConstInt( # res/v1x/grover.cq:10:11..14
-      value: 3
-    )
-    ConstInt(
-      value: 6
+    IndexRange(
+      first: 6
+      last: 6
     )
   ]
 )
@@ -2,12 +2,22 @@
 #include "cqasm-tree.hpp"
 #include "cqasm-version.hpp"
 #include "mock_analyzer.hpp"
+#include "v3x/cqasm.hpp"
 #include "v3x/cqasm-analyzer.hpp"
 #include "v3x/cqasm-ast.hpp"
+#include "v3x/cqasm-functions.hpp"
+#include "v3x/cqasm-parse-helper.hpp"
 #include "v3x/cqasm-parse-result.hpp"
 
+#include <cmath>  // sin
+#include <fmt/format.h>
 #include <functional>
 #include <gmock/gmock.h>
+#include <memory>  // make_shared
+#include <memory_resource>  // memory_resource, new_delete_resource
+#include <string_view>
+#include <thread>
+#include <vector>
 
 using namespace ::testing;
 
@@ -99,6 +109,40 @@ TEST(Analyzer, pop_scope) {
     analyzer.pop_scope();
     EXPECT_TRUE(analyzer.scope_stack().empty());
 }
+TEST(Analyzer, resolve_variable_does_not_copy_the_value) {
+    MockAnalyzer analyzer{};
+    const auto value = values::Value{ tree::make<values::ConstInt>(42) };
+    analyzer.register_variable("x", value);
+    EXPECT_EQ(analyzer.resolve_variable("x").get_ptr(), value.get_ptr());
+}
+TEST(Analyzer, resolve_variable_registered_in_the_config_from_an_inner_scope) {
+    MockAnalyzer analyzer{};
+    analyzer.register_variable("x", tree::make<values::ConstInt>(42));
+    analyzer.push_scope();
+    EXPECT_EQ(analyzer.resolve_variable("x")->as_const_int()->value, 42);
+    EXPECT_THROW((void) analyzer.resolve_variable("y"), resolver::NameResolutionFailure);
+}
+TEST(Analyzer, resolve_variable_from_an_outer_scope) {
+    MockAnalyzer analyzer{};
+    const auto outer_x = tree::make<semantic::Variable>("x", tree::make<types::Int>(1));
+    analyzer.add_variable_to_current_scope(outer_x);
+    analyzer.push_scope();
+    const auto inner_y = tree::make<semantic::Variable>("y", tree::make<types::Int>(1));
+    analyzer.add_variable_to_current_scope(inner_y);
+    EXPECT_EQ(&*analyzer.resolve_variable("x")->as_variable_ref()->variable, &*outer_x);
+    EXPECT_EQ(&*analyzer.resolve_variable("y")->as_variable_ref()->variable, &*inner_y);
+    analyzer.pop_scope();
+    EXPECT_EQ(&*analyzer.resolve_variable("x")->as_variable_ref()->variable, &*outer_x);
+    EXPECT_THROW((void) analyzer.resolve_variable("y"), resolver::NameResolutionFailure);
+}
+TEST(Analyzer, resolve_variable_from_an_inner_scope_shadows_the_outer_scope) {
+    MockAnalyzer analyzer{};
+    analyzer.add_variable_to_current_scope(tree::make<semantic::Variable>("x", tree::make<types::Int>(1)));
+    analyzer.push_scope();
+    const auto inner_x = tree::make<semantic::Variable>("x", tree::make<types::Float>(1));
+    analyzer.add_variable_to_current_scope(inner_x);
+    EXPECT_EQ(&*analyzer.resolve_variable("x")->as_variable_ref()->variable, &*inner_x);
+}
 TEST(Analyzer, add_statement_to_current_scope) {
     MockAnalyzer analyzer{};
     auto statement = tree::make<semantic::ReturnStatement>(tree::make<values::ConstInt>(42));
@@ -139,4 +183,269 @@ TEST(Analyzer, add_statement_with_source_location_information_to_current_scope_a
     EXPECT_EQ(block_final_source_location.range, (annotations::SourceLocation::Range{ { 5, 15 }, { 11, 20 } }));
 }
 
+
+class AnalyzerConfigTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto config = std::make_shared<AnalyzerConfig>();
+        config->register_default_mappings();
+        config->register_default_functions();
+        config->register_instruction("h", "Q");
+        config->register_instruction("cnot", "QQ");
+        config_ = config;
+    }
+
+    std::shared_ptr<const AnalyzerConfig> config_;
+    std::string program_ = "version 3.0\nqubit[2] q\nh q[0]\ncnot q[0], q[1]\n";
+};
+
+TEST_F(AnalyzerConfigTest, analyze_back_to_back_on_the_same_analyzer) {
+    auto analyzer = Analyzer{ config_ };
+    auto first_result = analyzer.analyze_string(program_, std::nullopt);
+    auto second_result = analyzer.analyze_string(program_, std::nullopt);
+    ASSERT_TRUE(first_result.errors.empty());
+    ASSERT_TRUE(second_result.errors.empty());
+    EXPECT_EQ(first_result.root->block->statements.size(), 2);
+    EXPECT_EQ(second_result.root->block->statements.size(), 2);
+    EXPECT_EQ(second_result.root->variables.size(), 1);
+}
+TEST_F(AnalyzerConfigTest, analyzer_shares_config) {
+    auto analyzer = Analyzer{ config_ };
+    EXPECT_EQ(analyzer.config(), config_);
+}
+TEST_F(AnalyzerConfigTest, registering_on_analyzer_does_not_modify_shared_config) {
+    auto analyzer = Analyzer{ config_ };
+    analyzer.register_instruction("x", "Q");
+    EXPECT_NE(analyzer.config(), config_);
+    EXPECT_TRUE(analyzer.analyze_string("version 3.0\nqubit q\nx q\n", std::nullopt).errors.empty());
+    EXPECT_FALSE(Analyzer{ config_ }.analyze_string("version 3.0\nqubit q\nx q\n", std::nullopt).errors.empty());
+}
+TEST_F(AnalyzerConfigTest, registering_on_analyzer_does_not_modify_the_config_it_returned) {
+    auto analyzer = Analyzer{};
+    analyzer.register_instruction("h", "Q");
+    const auto config = analyzer.config();
+    analyzer.register_instruction("x", "Q");
+    EXPECT_NE(analyzer.config(), config);
+    EXPECT_TRUE(Analyzer{ config }.analyze_string("version 3.0\nqubit q\nh q\n", std::nullopt).errors.empty());
+    EXPECT_FALSE(Analyzer{ config }.analyze_string("version 3.0\nqubit q\nx q\n", std::nullopt).errors.empty());
+}
+TEST_F(AnalyzerConfigTest, registering_on_a_copy_of_an_analyzer_does_not_modify_the_original) {
+    auto original = Analyzer{};
+    original.register_instruction("h", "Q");
+    auto copy = original;
+    original.register_instruction("x", "Q");
+    copy.register_instruction("y", "Q");
+    EXPECT_TRUE(original.analyze_string("version 3.0\nqubit q\nx q\n", std::nullopt).errors.empty());
+    EXPECT_FALSE(original.analyze_string("version 3.0\nqubit q\ny q\n", std::nullopt).errors.empty());
+    EXPECT_TRUE(copy.analyze_string("version 3.0\nqubit q\ny q\n", std::nullopt).errors.empty());
+    EXPECT_FALSE(copy.analyze_string("version 3.0\nqubit q\nx q\n", std::nullopt).errors.empty());
+}
+TEST_F(AnalyzerConfigTest, registered_variable_is_visible_to_every_analysis) {
+    static constexpr std::string_view program = "version 3.0\nqubit[2] q\nh q[k]\n";
+    auto analyzer = Analyzer{ config_ };
+    analyzer.register_variable("k", tree::make<values::ConstInt>(1));
+    EXPECT_TRUE(analyzer.analyze_string(std::string{ program }, std::nullopt).errors.empty());
+    EXPECT_TRUE(analyzer.analyze_string(std::string{ program }, std::nullopt).errors.empty());
+    EXPECT_FALSE(Analyzer{ config_ }.analyze_string(std::string{ program }, std::nullopt).errors.empty());
+}
+TEST_F(AnalyzerConfigTest, concurrent_analyses_on_a_shared_config) {
+    static constexpr size_t number_of_threads = 8;
+    static constexpr size_t number_of_analyses_per_thread = 16;
+    std::vector<size_t> number_of_successes(number_of_threads);
+    std::vector<std::thread> threads{};
+    for (size_t i = 0; i < number_of_threads; ++i) {
+        threads.emplace_back([this, &number_of_successes, i]() {
+            for (size_t j = 0; j < number_of_analyses_per_thread; ++j) {
+                auto result = Analyzer{ config_ }.analyze_string(program_, std::nullopt);
+                if (result.errors.empty() && result.root->block->statements.size() == 2) {
+                    number_of_successes[i]++;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (const auto &successes : number_of_successes) {
+        EXPECT_EQ(successes, number_of_analyses_per_thread);
+    }
+}
+TEST_F(AnalyzerConfigTest, analyze_batch_keeps_the_order_of_the_programs) {
+    static constexpr size_t number_of_programs = 64;
+    std::vector<std::string> programs{};
+    for (size_t i = 0; i < number_of_programs; ++i) {
+        // Every other program has a semantic error: index i + 2 is out of range
+        programs.push_back(fmt::format("version 3.0\nqubit[{}] q\nh q[{}]\n", i + 2, i % 2 ? i + 2 : i));
+    }
+    std::vector<std::string_view> views{ programs.begin(), programs.end() };
+    auto results = Analyzer{ config_ }.analyze_batch(views, 4);
+    ASSERT_EQ(results.size(), number_of_programs);
+    for (size_t i = 0; i < number_of_programs; ++i) {
+        if (i % 2) {
+            EXPECT_EQ(results[i].errors.size(), 1);
+        } else {
+            ASSERT_TRUE(results[i].errors.empty());
+            EXPECT_EQ(results[i].root->variables[0]->typ->as_qubit_array()->size, static_cast<primitives::Int>(i + 2));
+        }
+    }
+}
+TEST_F(AnalyzerConfigTest, analyze_batch_on_a_single_thread) {
+    std::vector<std::string_view> views{ program_, "version 3.0\nqubit q\nx q\n" };
+    auto results = Analyzer{ config_ }.analyze_batch(views, 1);
+    ASSERT_EQ(results.size(), 2);
+    EXPECT_TRUE(results[0].errors.empty());
+    EXPECT_FALSE(results[1].errors.empty());
+}
+TEST_F(AnalyzerConfigTest, analyze_batch_of_no_programs) {
+    EXPECT_TRUE(Analyzer{ config_ }.analyze_batch({}).empty());
+}
+TEST_F(AnalyzerConfigTest, analyze_with_arena) {
+    auto expected = Analyzer{ config_ }.analyze_string(program_, std::nullopt);
+    auto analyzer = std::make_unique<Analyzer>(config_);
+    analyzer->use_arena = true;
+    auto result = analyzer->analyze_string(program_, std::nullopt);
+    analyzer.reset();
+    ASSERT_TRUE(result.errors.empty());
+    EXPECT_NE(result.arena, nullptr);
+    EXPECT_EQ(expected.arena, nullptr);
+    EXPECT_EQ(result.to_strings(), expected.to_strings());
+}
+TEST_F(AnalyzerConfigTest, analyze_with_arena_after_the_previous_result_is_destroyed) {
+    auto analyzer = Analyzer{ config_ };
+    analyzer.use_arena = true;
+    {
+        auto first_result = analyzer.analyze_string(program_, std::nullopt);
+        ASSERT_TRUE(first_result.errors.empty());
+    }
+    auto second_result = analyzer.analyze_string(program_, std::nullopt);
+    ASSERT_TRUE(second_result.errors.empty());
+    EXPECT_EQ(second_result.root->block->statements.size(), 2);
+}
+TEST_F(AnalyzerConfigTest, analyze_batch_with_arena) {
+    std::vector<std::string_view> views{ program_, program_, program_ };
+    auto analyzer = Analyzer{ config_ };
+    analyzer.use_arena = true;
+    for (const auto &result : analyzer.analyze_batch(views, 2)) {
+        ASSERT_TRUE(result.errors.empty());
+        EXPECT_EQ(result.root->block->statements.size(), 2);
+    }
+}
+TEST_F(AnalyzerConfigTest, folds_constants_with_the_default_functions) {
+    EXPECT_TRUE(config_->folds_constants());
+    EXPECT_FALSE(AnalyzerConfig{}.folds_constants());
+}
+TEST_F(AnalyzerConfigTest, does_not_fold_constants_when_a_default_function_is_overridden) {
+    auto analyzer = Analyzer{ config_ };
+    analyzer.register_function_impl("operator+", "ii", functions::op_add_ii);
+    EXPECT_FALSE(analyzer.config()->folds_constants());
+    EXPECT_TRUE(config_->folds_constants());
+}
+TEST_F(AnalyzerConfigTest, folds_constants_when_a_function_other_than_the_default_ones_is_registered) {
+    auto analyzer = Analyzer{ config_ };
+    analyzer.register_function_impl("add", "ii", functions::op_add_ii);
+    EXPECT_TRUE(analyzer.config()->folds_constants());
+    EXPECT_NO_THROW((void) analyzer.config()->function_impl_table().resolve(
+        "add", values::Values{ {
+            values::Value{ tree::make<values::ConstInt>(1) }, values::Value{ tree::make<values::ConstInt>(2) } } }));
+}
+TEST_F(AnalyzerConfigTest, folding_constants_does_not_change_the_analysis) {
+    const auto program = std::string{
+        "version 3.0\n"
+        "float f = pi / 2 * (1 - 1 / 3) + sqrt(2) ** -1\n"
+        "int i = abs(-7) % 4 << 2 ^ ~1\n"
+        "bool b = 1 < 2.5 && !false ^^ (true ? 1 : 0.5) == 1\n"
+        "float g = f * 2\n"
+    };
+    // Registering the same implementation again overrides a default function, which disables folding
+    auto analyzer = Analyzer{ config_ };
+    analyzer.register_function_impl("operator+", "ii", functions::op_add_ii);
+    auto expected = analyzer.analyze_string(program, std::nullopt);
+    auto result = Analyzer{ config_ }.analyze_string(program, std::nullopt);
+    ASSERT_TRUE(expected.errors.empty());
+    ASSERT_TRUE(result.errors.empty());
+    EXPECT_EQ(result.to_strings(), expected.to_strings());
+}
+TEST_F(AnalyzerConfigTest, element_wise_operations_on_constant_arrays) {
+    auto result = Analyzer{ config_ }.analyze_string(
+        "version 3.0\nfloat[3] a = sin({0, 1, 2}) * 2\nbool[2] b = {1, 2} < 1.5\n", std::nullopt);
+    ASSERT_TRUE(result.errors.empty());
+    const auto &statements = result.root->block->statements;
+    ASSERT_EQ(statements.size(), 2);
+    const auto *a = statements[0]->as_assignment_statement()->rhs->as_const_float_array();
+    ASSERT_NE(a, nullptr);
+    ASSERT_EQ(a->value.size(), 3);
+    EXPECT_DOUBLE_EQ(a->value[2]->value, std::sin(2.) * 2);
+    const auto *b = statements[1]->as_assignment_statement()->rhs->as_const_bool_array();
+    ASSERT_NE(b, nullptr);
+    ASSERT_EQ(b->value.size(), 2);
+    EXPECT_TRUE(b->value[0]->value);
+    EXPECT_FALSE(b->value[1]->value);
+}
+TEST_F(AnalyzerConfigTest, index_ranges_keep_the_source_location_of_their_index_entry) {
+    auto result = Analyzer{ config_ }.analyze_string("version 3.0\nqubit[4] q\nh q[0, 1:2, 3]\n", std::nullopt);
+    ASSERT_TRUE(result.errors.empty());
+    const auto *index_ref = result.root->block->statements[0]->as_instruction()->operands[0]->as_index_ref();
+    ASSERT_NE(index_ref, nullptr);
+    const auto &indices = index_ref->indices;
+    ASSERT_EQ(indices.size(), 3);
+    EXPECT_EQ(values::expand_indices(indices), (std::vector<primitives::Int>{ 0, 1, 2, 3 }));
+    const auto &location_0 = indices[0]->get_annotation<annotations::SourceLocation>().range;
+    const auto &location_1_2 = indices[1]->get_annotation<annotations::SourceLocation>().range;
+    const auto &location_3 = indices[2]->get_annotation<annotations::SourceLocation>().range;
+    EXPECT_EQ(location_0.first.line, 3);
+    EXPECT_LT(location_0.last, location_1_2.first);
+    EXPECT_LT(location_1_2.first, location_1_2.last);
+    EXPECT_LT(location_1_2.last, location_3.first);
+}
+
+/**
+ * Memory resource counting the allocations it forwards to the default resource.
+ */
+class CountingResource : public std::pmr::memory_resource {
+public:
+    std::size_t allocations = 0;
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        allocations++;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+TEST(Arena, make_allocates_from_the_current_arena_only) {
+    CountingResource upstream{};
+    tree::Arena arena{ &upstream };
+    auto outside = tree::make<values::ConstInt>(1);
+    EXPECT_EQ(upstream.allocations, 0);
+    tree::One<values::ConstInt> inside{};
+    {
+        tree::ArenaScope scope{ arena };
+        EXPECT_EQ(tree::current_arena(), &arena);
+        inside = tree::make<values::ConstInt>(2);
+    }
+    EXPECT_EQ(upstream.allocations, 1);
+    EXPECT_EQ(tree::current_arena(), nullptr);
+    auto after = tree::make<values::ConstInt>(3);
+    EXPECT_EQ(upstream.allocations, 1);
+    EXPECT_EQ(outside->value, 1);
+    EXPECT_EQ(inside->value, 2);
+    EXPECT_EQ(after->value, 3);
+    inside.reset();
+}
+
+TEST(DefaultAnalyzerConfig, is_built_once_and_shared) {
+    auto config = default_analyzer_config();
+    EXPECT_EQ(default_analyzer_config(), config);
+    EXPECT_EQ(default_analyzer().config(), config);
+}
+TEST(DefaultAnalyzerConfig, unsupported_api_version) {
+    EXPECT_THROW((void) default_analyzer_config("4.0"), std::invalid_argument);
+}
+
 }  // namespace cqasm::v3x::analyzer
@@ -1,13 +1,20 @@
 #include "cqasm-functions.hpp"
 #include "v3x/cqasm-functions.hpp"
+#include "cqasm-error.hpp"
 #include "v3x/cqasm-primitives.hpp"
 
+#include <cstdint>  // uint8_t
 #include <gmock/gmock.h>
+#include <type_traits>  // is_same_v
+#include <vector>
 
 namespace functions = cqasm::v3x::functions;
 namespace primitives = cqasm::v3x::primitives;
 namespace values = cqasm::v3x::values;
 
+using ::testing::ElementsAre;
+using ::testing::DoubleNear;
+
 
 TEST(op_neg_f, f_0) { EXPECT_EQ((invoke_unary<functions::op_neg_f>(0.)), 0.); }
 TEST(op_neg_f, f_5) { EXPECT_EQ((invoke_unary<functions::op_neg_f>(5.)), -5.); }
@@ -92,3 +99,55 @@ TEST(fn_atan_f, f_point_2) { EXPECT_NEAR((invoke_unary<functions::fn_atan_f>(.2)
 TEST(fn_asinh_f, f_2) { EXPECT_NEAR((invoke_unary<functions::fn_asinh_f>(2.)), 1.44363, 0.00001); }
 TEST(fn_acosh_f, f_2) { EXPECT_NEAR((invoke_unary<functions::fn_acosh_f>(2.)), 1.31695, 0.00001); }
 TEST(fn_atanh_f, f_point_2) { EXPECT_NEAR((invoke_unary<functions::fn_atanh_f>(.2)), 0.20273, 0.00001); }
+
+TEST(op_neg_Y, Y_m5_0_5) {
+    auto values = values::Values{{ make_array_value<values::ConstIntArray>(std::vector<primitives::Int>{ -5, 0, 5 }) }};
+    EXPECT_THAT(invoke_array<functions::op_neg_Y>(values), ElementsAre(5, 0, -5));
+}
+TEST(op_add_Z, ZZ_1_2_plus_3_4) {
+    auto values = values::Values{{
+        make_array_value<values::ConstFloatArray>(std::vector<primitives::Float>{ 1., 2. }),
+        make_array_value<values::ConstFloatArray>(std::vector<primitives::Float>{ 3., 4. })
+    }};
+    EXPECT_THAT(invoke_array<functions::op_add_Z>(values), ElementsAre(4., 6.));
+}
+TEST(op_add_Z, ZZ_of_different_sizes) {
+    auto values = values::Values{{
+        make_array_value<values::ConstFloatArray>(std::vector<primitives::Float>{ 1., 2. }),
+        make_array_value<values::ConstFloatArray>(std::vector<primitives::Float>{ 3. })
+    }};
+    EXPECT_THROW(functions::op_add_Z(values), cqasm::error::AnalysisError);
+}
+TEST(op_mul_Z, Zf_1_2_times_2) {
+    auto values = values::Values{{
+        make_array_value<values::ConstFloatArray>(std::vector<primitives::Float>{ 1., 2. }),
+        cqasm::tree::make<values::ConstFloat>(2.)
+    }};
+    EXPECT_THAT(invoke_array<functions::op_mul_Z>(values), ElementsAre(2., 4.));
+}
+TEST(op_sub_Y, iY_10_minus_1_2) {
+    auto values = values::Values{{
+        cqasm::tree::make<values::ConstInt>(10),
+        make_array_value<values::ConstIntArray>(std::vector<primitives::Int>{ 1, 2 })
+    }};
+    EXPECT_THAT(invoke_array<functions::op_sub_Y>(values), ElementsAre(9, 8));
+}
+TEST(op_lt_Y, YY_1_5_lt_3_3) {
+    auto values = values::Values{{
+        make_array_value<values::ConstIntArray>(std::vector<primitives::Int>{ 1, 5 }),
+        make_array_value<values::ConstIntArray>(std::vector<primitives::Int>{ 3, 3 })
+    }};
+    EXPECT_THAT(invoke_array<functions::op_lt_Y>(values), ElementsAre(true, false));
+}
+TEST(op_ne_X, XX_true_false_true_ne_true_true_false) {
+    auto values = values::Values{{
+        make_array_value<values::ConstBoolArray>(std::vector<std::uint8_t>{ true, false, true }),
+        make_array_value<values::ConstBoolArray>(std::vector<std::uint8_t>{ true, true, false })
+    }};
+    static_assert(std::is_same_v<decltype(invoke_array<functions::op_ne_X>(values)), std::vector<std::uint8_t>>);
+    EXPECT_THAT(invoke_array<functions::op_ne_X>(values), ElementsAre(false, true, true));
+}
+TEST(fn_sin_Z, Z_0_2) {
+    auto values = values::Values{{ make_array_value<values::ConstFloatArray>(std::vector<primitives::Float>{ 0., 2. }) }};
+    EXPECT_THAT(invoke_array<functions::fn_sin_Z>(values), ElementsAre(0., DoubleNear(0.90929, 0.00001)));
+}
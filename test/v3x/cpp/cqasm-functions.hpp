@@ -1,7 +1,10 @@
 #pragma once
 
+#include "v3x/cqasm-functions.hpp"
 #include "v3x/cqasm-values.hpp"
 
+#include <vector>
+
 namespace values = cqasm::v3x::values;
 
 
@@ -48,3 +51,20 @@ auto invoke_ternary(bool condition, ParamsType if_true, ParamsType if_false) {
     auto ret = F(values);
     return dynamic_cast<FReturnType&>(*ret).value;
 }
+
+/**
+ * Convenience function template for invoking element-wise array operators and functions:
+ *
+ * - The caller builds the arguments with make_array_value, for arrays, or cqasm::tree::make, for scalars, and
+ *   receives the elements of the returned array as a vector of simple types.
+ */
+template <typename ConstTypeArray, typename T>
+values::Value make_array_value(const std::vector<T> &elements) {
+    return cqasm::v3x::functions::make_array<ConstTypeArray>(elements);
+}
+
+template <auto F>
+auto invoke_array(const values::Values &values) {
+    using FReturnType = typename decltype(F)::return_type;
+    return cqasm::v3x::functions::array_operand<FReturnType>(F(values));
+}
@@ -10,6 +10,7 @@
 #include <fmt/format.h>
 #include <gmock/gmock.h>
 #include <memory>  // make_unique, unique_ptr
+#include <sstream>  // ostringstream
 #include <stdexcept>  // runtime_error
 #include <string>
 
@@ -98,4 +99,96 @@ TEST_F(ParseHelperParseTest, parse_result_errors_is_empty_and_root_is_well_forme
     EXPECT_EQ(version, version_3_0);
 }
 
+
+TEST(parse_view, ascii_and_non_ascii_inputs_build_the_same_ast) {
+    // Non-ASCII inputs are not scanned in place, but decoded first
+    const std::string ascii_data = "version 3\nqubit[2] q\nH q[0]  // comment\n";
+    const std::string non_ascii_data = "version 3\nqubit[2] q\nH q[0]  // comm\u00e9nt\n";
+    auto ascii_result = parse_view(ascii_data, std::nullopt);
+    auto non_ascii_result = parse_view(non_ascii_data, std::nullopt);
+    EXPECT_TRUE(ascii_result.errors.empty());
+    EXPECT_TRUE(non_ascii_result.errors.empty());
+    std::ostringstream ascii_oss{};
+    std::ostringstream non_ascii_oss{};
+    ascii_oss << *ascii_result.root;
+    non_ascii_oss << *non_ascii_result.root;
+    EXPECT_EQ(ascii_oss.str(), non_ascii_oss.str());
+}
+TEST(parse_view, syntax_error_location) {
+    auto parse_result = parse_view("version 3\nqubit[2] q\nH q[0\n", "input.cq");
+    ASSERT_EQ(parse_result.errors.size(), 1);
+    EXPECT_THAT(fmt::format("{}", parse_result.errors[0]), ::testing::StartsWith("Error at input.cq:"));
+}
+
+class ParsePredictionModeTest : public ::testing::Test {
+protected:
+    static std::string dump(const ParseResult &parse_result) {
+        std::ostringstream oss{};
+        if (parse_result.root.is_well_formed()) {
+            oss << *parse_result.root;
+        }
+        for (const auto &error : parse_result.errors) {
+            oss << fmt::format("{}", error) << "\n";
+        }
+        return oss.str();
+    }
+    static void ExpectSameResult(const std::string &data) {
+        EXPECT_EQ(dump(parse_string(data, "input.cq", PredictionMode::sll_first)),
+            dump(parse_string(data, "input.cq", PredictionMode::ll)));
+    }
+};
+
+TEST_F(ParsePredictionModeTest, correct_program) {
+    ExpectSameResult(
+        "version 3\n"
+        "qubit[2] q\n"
+        "bit[2] b\n"
+        "int i = 1 + 2 * 3 ** 4 << 1 == 2 ? -i : ~i\n"
+        "H q[0]\n"
+        "CNOT q[0], q[1]\n"
+        "b = measure q\n");
+}
+TEST_F(ParsePredictionModeTest, incorrect_program) {
+    ExpectSameResult(
+        "version 3\n"
+        "qubit[2] q\n"
+        "H q[0\n"
+        "CNOT q[0], q[1]\n");
+}
+
+class DfaCacheTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        set_dfa_cache_limit(0);
+    }
+
+    std::string data = "version 3\nqubit[2] q\nH q[0]\n";
+};
+
+TEST_F(DfaCacheTest, warm_up_program_parses_without_errors) {
+    EXPECT_NO_THROW(warm_up());
+}
+TEST_F(DfaCacheTest, warm_up_fills_the_cache) {
+    clear_dfa_cache();
+    EXPECT_EQ(dfa_cache_size(), 0);
+    warm_up();
+    EXPECT_GT(dfa_cache_size(), 0);
+}
+TEST_F(DfaCacheTest, warm_up_fills_the_cache_for_both_prediction_modes) {
+    clear_dfa_cache();
+    warm_up();
+    auto size_after_warm_up = dfa_cache_size();
+    warm_up();
+    EXPECT_EQ(dfa_cache_size(), size_after_warm_up);
+}
+TEST_F(DfaCacheTest, cache_is_cleared_when_exceeding_the_limit) {
+    clear_dfa_cache();
+    parse_string(data, std::nullopt);
+    auto size_after_one_parse = dfa_cache_size();
+    warm_up();
+    set_dfa_cache_limit(1);
+    parse_string(data, std::nullopt);
+    EXPECT_EQ(dfa_cache_size(), size_after_one_parse);
+}
+
 } // namespace cqasm::v3x::parser
@@ -1,7 +1,10 @@
+#include "cqasm-overload.hpp"
 #include "v3x/cqasm-semantic-gen.hpp"
 #include "v3x/cqasm-values.hpp"
 
 #include <gtest/gtest.h>
+#include <string>
+#include <vector>
 
 
 namespace cqasm::v3x::values {
@@ -25,10 +28,6 @@ static const values::Value bool_true_value = tree::make<values::ConstBool>(true)
 static const values::Value int_0_value = tree::make<values::ConstInt>(0);
 static const values::Value int_1_value = tree::make<values::ConstInt>(1);
 static const values::Value int_2_value = tree::make<values::ConstInt>(2);
-static const values::Value int_3_value = tree::make<values::ConstInt>(3);
-static const values::Value int_4_value = tree::make<values::ConstInt>(4);
-static const values::Value int_5_value = tree::make<values::ConstInt>(5);
-static const values::Value int_6_value = tree::make<values::ConstInt>(6);
 static const values::Value float_0_0_value = tree::make<values::ConstFloat>(0.0);
 static const values::Value float_1_0_value = tree::make<values::ConstFloat>(1.0);
 static const values::Value axis_x_value = tree::make<values::ConstAxis>();
@@ -58,11 +57,12 @@ static const values::Value bool_array_of_3_variable_ref = tree::make<values::Var
 
 // index ref values
 static const auto index_2_value = tree::make<values::IndexRef>(bool_array_of_10_variable,
-    tree::Many<values::ConstInt>{ int_2_value });
+    tree::Many<values::IndexRange>{ tree::make<values::IndexRange>(2, 2) });
 static const auto index_2_to_5_value = tree::make<values::IndexRef>(bool_array_of_10_variable,
-    tree::Many<values::ConstInt>{ int_2_value, int_3_value, int_4_value, int_5_value });
+    tree::Many<values::IndexRange>{ tree::make<values::IndexRange>(2, 5) });
 static const auto index_2_4_6_value = tree::make<values::IndexRef>(bool_array_of_10_variable,
-    tree::Many<values::ConstInt>{ int_2_value, int_4_value, int_6_value });
+    tree::Many<values::IndexRange>{
+        tree::make<values::IndexRange>(2, 2), tree::make<values::IndexRange>(4, 4), tree::make<values::IndexRange>(6, 6) });
 
 // Semantic function returning bool
 static const auto function_returning_bool = tree::make<semantic::Function>("fb", bool_type);
@@ -96,6 +96,31 @@ TEST(promote, bool_array_to_float_array) { EXPECT_TRUE(promote(bool_array_of_3_v
 TEST(promote, int_array_to_int_array) { EXPECT_TRUE(promote(int_array_of_3_value, int_array_of_3_type)->equals(*int_array_of_3_value)); }
 TEST(promote, int_array_to_float_array) { EXPECT_TRUE(promote(int_array_of_3_value, float_array_of_3_type)->equals(*float_array_of_3_value)); }
 TEST(promote, float_array_to_float_array) { EXPECT_TRUE(promote(float_array_of_3_value, float_array_of_3_type)->equals(*float_array_of_3_value)); }
+TEST(promote, promoted_array_elements_are_packed) {
+    const auto promoted = promote(bool_array_of_3_value, float_array_of_3_type);
+    const auto &elements = promoted->as_const_float_array()->value;
+    ASSERT_EQ(elements.size(), 3);
+    EXPECT_EQ(&*elements.at(1), &*elements.at(0) + 1);
+    EXPECT_EQ(&*elements.at(2), &*elements.at(0) + 2);
+}
+
+TEST(packed_span, of_packed_array_elements) {
+    const auto promoted = promote(int_array_of_3_value, float_array_of_3_type);
+    const auto elements = packed_span(promoted->as_const_float_array()->value);
+    ASSERT_TRUE(elements.has_value());
+    ASSERT_EQ(elements->size(), 3);
+    EXPECT_EQ((*elements)[0].value, 1.0);
+    EXPECT_EQ((*elements)[1].value, 0.0);
+    EXPECT_EQ((*elements)[2].value, 0.0);
+}
+TEST(packed_span, of_array_elements_added_one_at_a_time) {
+    EXPECT_FALSE(packed_span(int_array_of_3_value->as_const_int_array()->value).has_value());
+}
+TEST(packed_span, of_empty_array) {
+    const auto elements = packed_span(tree::Many<values::ConstInt>{});
+    ASSERT_TRUE(elements.has_value());
+    EXPECT_TRUE(elements->empty());
+}
 
 // For a variable or a return value, a promotion is just a check.
 // If the check is successful, the variable or return value is returned
@@ -135,6 +160,9 @@ TEST(type_of, function_with_bool_array_return_type) { EXPECT_TRUE(types::type_ch
 TEST(type_of, function_call_to_function_with_bool_return_type) { EXPECT_TRUE(types::type_check(type_of(bool_return_value), bool_type)); }
 TEST(type_of, function_call_to_function_with_bool_array_return_type) { EXPECT_TRUE(types::type_check(type_of(bool_array_of_3_return_value), bool_array_of_3_type)); }
 
+TEST(type_of, constants_of_the_same_type_share_an_interned_type) { EXPECT_EQ(type_of(int_1_value).get_ptr(), type_of(int_2_value).get_ptr()); }
+TEST(type_of, interned_type_of_const_int) { EXPECT_EQ(type_of(int_1_value).get_ptr(), types::interned<types::Int>().get_ptr()); }
+
 TEST(size_of, const_axis) { EXPECT_EQ(size_of(axis_x_value), 3); }
 TEST(size_of, const_bool) { EXPECT_EQ(size_of(bool_true_value), 1); }
 TEST(size_of, const_int) { EXPECT_EQ(size_of(int_1_value), 1); }
@@ -151,4 +179,51 @@ TEST(size_of, function_returning_bool_array_of_3) { EXPECT_EQ(size_of(function_r
 TEST(size_of, bool_return_value) { EXPECT_EQ(size_of(bool_return_value), 1); }
 TEST(size_of, bool_array_of_3_return_value) { EXPECT_EQ(size_of(bool_array_of_3_return_value), 3); }
 
+TEST(expand_indices, bool_b_10__b_2) { EXPECT_EQ(expand_indices(index_2_value->indices), (std::vector<primitives::Int>{ 2 })); }
+TEST(expand_indices, bool_b_10__b_2_to_5) { EXPECT_EQ(expand_indices(index_2_to_5_value->indices), (std::vector<primitives::Int>{ 2, 3, 4, 5 })); }
+TEST(expand_indices, bool_b_10__b_2_4_6) { EXPECT_EQ(expand_indices(index_2_4_6_value->indices), (std::vector<primitives::Int>{ 2, 4, 6 })); }
+
+TEST(promotion_key, same_for_values_of_same_kind_and_type) { EXPECT_EQ(promotion_key(int_1_value), promotion_key(int_2_value)); }
+TEST(promotion_key, different_for_different_types) { EXPECT_NE(promotion_key(int_1_value), promotion_key(float_1_0_value)); }
+TEST(promotion_key, different_for_different_sizes) { EXPECT_NE(promotion_key(bool_array_of_2_value), promotion_key(bool_array_of_3_value)); }
+TEST(promotion_key, different_for_constant_and_index_ref) { EXPECT_NE(promotion_key(bool_true_value), promotion_key(index_2_value)); }
+
+TEST(OverloadResolver, memoized_resolution_promotes_arguments) {
+    overload::OverloadResolver<std::string, types::TypeBase, ValueBase> resolver{};
+    resolver.add_overload("int", types::from_spec("i"));
+    resolver.add_overload("float", types::from_spec("f"));
+    for (int i = 0; i < 2; ++i) {
+        auto [tag, args] = resolver.resolve(Values{ int_1_value });
+        EXPECT_EQ(tag, "float");
+        EXPECT_TRUE(args.at(0)->equals(*float_1_0_value));
+    }
+}
+TEST(OverloadResolver, memoized_failure) {
+    overload::OverloadResolver<std::string, types::TypeBase, ValueBase> resolver{};
+    resolver.add_overload("int", types::from_spec("i"));
+    EXPECT_THROW(static_cast<void>(resolver.resolve(Values{ float_1_0_value })), overload::OverloadResolutionFailure);
+    EXPECT_THROW(static_cast<void>(resolver.resolve(Values{ float_1_0_value })), overload::OverloadResolutionFailure);
+}
+TEST(OverloadResolver, adding_an_overload_invalidates_memoized_resolutions) {
+    overload::OverloadResolver<std::string, types::TypeBase, ValueBase> resolver{};
+    resolver.add_overload("int", types::from_spec("i"));
+    EXPECT_THROW(static_cast<void>(resolver.resolve(Values{ float_1_0_value })), overload::OverloadResolutionFailure);
+    resolver.add_overload("float", types::from_spec("f"));
+    EXPECT_EQ(resolver.resolve(Values{ float_1_0_value }).first, "float");
+}
+TEST(OverloadResolver, overloads_with_other_arities_are_ignored) {
+    overload::OverloadResolver<std::string, types::TypeBase, ValueBase> resolver{};
+    resolver.add_overload("one", types::from_spec("i"));
+    resolver.add_overload("two", types::from_spec("ii"));
+    EXPECT_EQ(resolver.resolve(Values{ int_1_value }).first, "one");
+    EXPECT_EQ(resolver.resolve(Values{ int_1_value, int_2_value }).first, "two");
+}
+TEST(OverloadResolver, argument_lists_too_long_to_memoize_are_resolved) {
+    overload::OverloadResolver<std::string, types::TypeBase, ValueBase> resolver{};
+    resolver.add_overload("five", types::from_spec("iiiii"));
+    const auto args = Values{ int_1_value, int_2_value, int_1_value, int_2_value, int_1_value };
+    EXPECT_EQ(resolver.resolve(args).first, "five");
+    EXPECT_EQ(resolver.resolve(args).first, "five");
+}
+
 }  // namespace cqasm::v3x::values
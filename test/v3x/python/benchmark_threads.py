@@ -0,0 +1,56 @@
+"""Measures how parsing and analysis scale with the number of Python threads.
+
+Every thread calls analyze_string on the same Analyzer, which releases the GIL while in C++.
+Not collected by the test runner. Run it with:  python3 test/v3x/python/benchmark_threads.py
+"""
+import argparse
+import os
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+import cqasm.v3x as cq
+
+
+def build_program(number_of_gates):
+    lines = ["version 3", "qubit[8] q", "bit[8] b"]
+    gates = ["h q[{}]", "x q[{}]", "rx q[{}], pi / 2", "cnot q[{}], q[{}]"]
+    for i in range(number_of_gates):
+        gate = gates[i % len(gates)]
+        lines.append(gate.format(i % 8, (i + 1) % 8))
+    lines.append("b = measure q")
+    return "\n".join(lines) + "\n"
+
+
+def run(analyzer, program, number_of_threads, number_of_programs):
+    start = time.perf_counter()
+    with ThreadPoolExecutor(max_workers=number_of_threads) as executor:
+        results = list(executor.map(lambda _: analyzer.analyze_string(program), range(number_of_programs)))
+    elapsed = time.perf_counter() - start
+    assert all(isinstance(result, cq.semantic.Program) for result in results)
+    return elapsed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--gates", type=int, default=1000, help="number of gates per program")
+    parser.add_argument("--programs", type=int, default=64, help="number of programs analyzed per run")
+    parser.add_argument("--max-threads", type=int, default=os.cpu_count() or 1, help="maximum number of threads")
+    args = parser.parse_args()
+
+    analyzer = cq.Analyzer()
+    program = build_program(args.gates)
+    cq.Analyzer.warm_up()
+
+    number_of_threads = 1
+    baseline = None
+    print("{:>8} {:>12} {:>14} {:>8}".format("threads", "time (s)", "programs/s", "speedup"))
+    while number_of_threads <= args.max_threads:
+        elapsed = run(analyzer, program, number_of_threads, args.programs)
+        baseline = baseline or elapsed
+        print("{:>8} {:>12.3f} {:>14.1f} {:>8.2f}".format(
+            number_of_threads, elapsed, args.programs / elapsed, baseline / elapsed))
+        number_of_threads *= 2
+
+
+if __name__ == "__main__":
+    main()
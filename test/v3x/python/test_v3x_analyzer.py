@@ -1,4 +1,5 @@
 import unittest
+from concurrent.futures import ThreadPoolExecutor
 
 import cqasm.v3x as cq
 
@@ -53,11 +54,9 @@ class TestV3xAnalyzer(unittest.TestCase):
         self.assertEqual(h_operand.variable.name, "b'q'")
         self.assertIsInstance(h_operand.variable.typ, cq.types.QubitArray)
         self.assertEqual(h_operand.variable.typ.size, 5)
-        self.assertEqual(h_operand.indices[0].value, 0)
-        self.assertEqual(h_operand.indices[1].value, 1)
-        self.assertEqual(h_operand.indices[2].value, 2)
-        self.assertEqual(h_operand.indices[3].value, 3)
-        self.assertEqual(h_operand.indices[4].value, 4)
+        self.assertEqual(len(h_operand.indices), 1)
+        self.assertEqual(h_operand.indices[0].first, 0)
+        self.assertEqual(h_operand.indices[0].last, 4)
 
         measure_instruction = ast.block.statements[1]
         self.assertEqual(measure_instruction.name, "b'measure'")
@@ -83,3 +82,61 @@ class TestV3xAnalyzer(unittest.TestCase):
         errors = v3x_analyzer.analyze_string(program_str)
         expected_errors = ["Error at <unknown file name>:1:24..25: index 3 out of range (size 3)"]
         self.assertEqual(errors, expected_errors)
+
+    def test_analyze_string_lazy_returning_ast(self):
+        program_str = "version 3;qubit[5] q;bit[5] b;h q[0:4];b = measure q"
+        v3x_analyzer = cq.Analyzer()
+        ast = v3x_analyzer.analyze_string_lazy(program_str)
+
+        self.assertEqual(ast.type_name, "Program")
+        self.assertEqual(ast.version.items[0], 3)
+
+        self.assertEqual(len(ast.block.statements), 2)
+        h_instruction = ast.block.statements[0]
+        self.assertEqual(h_instruction.name, "b'h'")
+        h_operand = h_instruction.operands[0]
+        self.assertEqual(h_operand.variable.name, "b'q'")
+        self.assertEqual(h_operand.variable, ast.variables[0])
+        self.assertIsInstance(h_operand.variable.typ.materialize(), cq.types.QubitArray)
+        self.assertEqual(h_operand.variable.typ.size, 5)
+        self.assertEqual([(index.first, index.last) for index in h_operand.indices], [(0, 4)])
+
+        measure_instruction = ast.block.statements[1]
+        self.assertEqual(measure_instruction.name, "b'measure'")
+        self.assertEqual(measure_instruction.operands[0].variable.name, "b'b'")
+
+    def test_analyze_string_lazy_returning_errors(self):
+        program_str = "version 3;qubit[3] q;x q[3]"
+        v3x_analyzer = cq.Analyzer()
+        errors = v3x_analyzer.analyze_string_lazy(program_str)
+        expected_errors = ["Error at <unknown file name>:1:24..25: index 3 out of range (size 3)"]
+        self.assertEqual(errors, expected_errors)
+
+    def test_parse_string_after_warm_up_and_clearing_the_cache(self):
+        program_str = "version 3;qubit[5] q;h q[0:4]"
+        cq.Analyzer.warm_up()
+        cq.Analyzer.clear_dfa_cache()
+        ast = cq.Analyzer.parse_string(program_str)
+        self.assertEqual(ast.version.items[0], 3)
+
+    def test_analyze_batch(self):
+        programs = ["version 3;qubit[3] q;x q[{}]".format(i) for i in range(8)]
+        v3x_analyzer = cq.Analyzer()
+        results = v3x_analyzer.analyze_batch(programs, 4)
+        self.assertEqual(len(results), 8)
+        for i, result in enumerate(results):
+            if i < 3:
+                self.assertIsInstance(result, cq.semantic.Program)
+            else:
+                self.assertEqual(result, ["Error at <unknown file name>:1:24..25: index {} out of range (size 3)".format(i)])
+
+    def test_analyze_string_concurrently_on_the_same_analyzer(self):
+        programs = ["version 3;qubit[3] q;x q[{}]".format(i % 4) for i in range(32)]
+        v3x_analyzer = cq.Analyzer()
+        with ThreadPoolExecutor(max_workers=8) as executor:
+            results = list(executor.map(v3x_analyzer.analyze_string, programs))
+        for i, result in enumerate(results):
+            if i % 4 < 3:
+                self.assertIsInstance(result, cq.semantic.Program)
+            else:
+                self.assertEqual(result, ["Error at <unknown file name>:1:24..25: index 3 out of range (size 3)"])